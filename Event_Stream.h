@@ -0,0 +1,194 @@
+// ***********************************************************************************
+// This file implements a live stream of events to browsers, as Server-Sent Events.
+//
+// A browser opens the stream with  new EventSource ( "/events" ),
+//   the web server hands the connection over to this stream ( Attach ),
+//   and from then on every event is pushed as
+//     event: <name>
+//     data: <JSON>
+//
+// Each client has a small send queue, flushed in loop as far as the TCP send buffer allows.
+// If an event doesn't fit in the queue, the client is too slow and is dropped,
+//   the browser reconnects by itself. So a slow client never blocks the node.
+// When no client is connected, Send returns at once, callers can test Active
+//   to skip building the event at all.
+//
+// Server-Sent Events are used instead of WebSockets : one direction is all that's needed,
+//   and there's no handshake ( SHA1 ) or framing to do.
+//
+// Public Functions implemented :
+//     bool Attach ( WiFiClient &Client ) {            // false if there's no free slot
+//     bool Active () {                                // true if a client is connected
+//     void Send ( const char *Event, const char *Data ) {
+//     void loop ( unsigned long Now ) {
+//     unsigned long Events, Dropped
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Event_Stream_h
+#define _Event_Stream_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version, Server-Sent Events
+// ***********************************************************************************
+String _Event_Stream_Version      = "0.1" ;
+String _Event_Stream_Version_Date = "18-10-2026" ;
+String _Event_Stream_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+#define EVENT_CLIENTS        2
+#define EVENT_QUEUE_SIZE     512      // per client
+#define EVENT_SIZE           160      // maximum length of one event
+#define EVENT_KEEPALIVE_MS   15000    // a comment line, also detects lost clients
+
+const char EVENT_STREAM_HEAD[] PROGMEM = "HTTP/1.1 200 OK\r\n\
+Content-Type: text/event-stream\r\n\
+Cache-Control: no-cache\r\n\
+Connection: keep-alive\r\n\r\n\
+retry: 5000\n\n" ;
+
+
+// ***********************************************************************************
+// A connected client with its send queue ( a ring )
+// ***********************************************************************************
+struct _Event_Client {
+  WiFiClient Client ;
+  bool       Used  = false ;
+  uint16_t   First = 0 ;
+  uint16_t   Len   = 0 ;
+  char       Queue [ EVENT_QUEUE_SIZE ] ;
+} ;
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _Event_Stream {
+
+  public:
+    unsigned long Events  = 0 ;       // events sent
+    unsigned long Dropped = 0 ;       // clients dropped because they were too slow
+
+    // ***********************************************************************
+    // Take over the connection of the web server, the head is queued
+    // ***********************************************************************
+    bool Attach ( WiFiClient &Client ) {
+      for ( int i = 0; i < EVENT_CLIENTS; i++ ) {
+        _Event_Client &C = _Clients [i] ;
+        if ( ! C.Used ) {
+          C.Client = Client ;
+          C.Used   = true ;
+          C.First  = 0 ;
+          C.Len    = 0 ;
+          char Head [ sizeof ( EVENT_STREAM_HEAD ) ] ;
+          strcpy_P ( Head, EVENT_STREAM_HEAD ) ;
+          _Push ( C, Head, strlen ( Head ) ) ;
+          _N += 1 ;
+          return true ;
+        }
+      }
+      return false ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    bool Active () {
+      return _N > 0 ;
+    }
+
+    // ***********************************************************************
+    // Queue the event for all clients, a client without room is dropped
+    // ***********************************************************************
+    void Send ( const char *Event, const char *Data ) {
+      if ( _N == 0 ) {
+        return ;
+      }
+      char Buffer [ EVENT_SIZE ] ;
+      int  Len = snprintf ( Buffer, sizeof ( Buffer ), "event: %s\ndata: %s\n\n", Event, Data ) ;
+      if ( Len >= (int) sizeof ( Buffer ) ) {
+        return ;
+      }
+      for ( int i = 0; i < EVENT_CLIENTS; i++ ) {
+        _Event_Client &C = _Clients [i] ;
+        if ( C.Used && ! _Push ( C, Buffer, Len ) ) {
+          Dropped += 1 ;
+          _Drop ( C ) ;
+        }
+      }
+      Events += 1 ;
+    }
+
+    // ***********************************************************************
+    // Flush the queues, only as much as fits in the TCP send buffers
+    // ***********************************************************************
+    void loop ( unsigned long Now ) {
+      if ( _N == 0 ) {
+        return ;
+      }
+      if ( ( Now - _Last_Keepalive ) > EVENT_KEEPALIVE_MS ) {
+        _Last_Keepalive = Now ;
+        for ( int i = 0; i < EVENT_CLIENTS; i++ ) {
+          if ( _Clients [i].Used ) {
+            _Push ( _Clients [i], ":\n\n", 3 ) ;
+          }
+        }
+      }
+      for ( int i = 0; i < EVENT_CLIENTS; i++ ) {
+        _Event_Client &C = _Clients [i] ;
+        if ( ! C.Used ) {
+          continue ;
+        }
+        if ( ! C.Client.connected () ) {
+          _Drop ( C ) ;
+          continue ;
+        }
+        // the contiguous part of the ring, the rest follows in the next loop
+        int Len = min ( (int) C.Len, EVENT_QUEUE_SIZE - C.First ) ;
+        Len = min ( Len, C.Client.availableForWrite () ) ;
+        if ( Len > 0 ) {
+          C.Client.write ( (const uint8_t*) C.Queue + C.First, Len ) ;
+          C.First = ( C.First + Len ) % EVENT_QUEUE_SIZE ;
+          C.Len  -= Len ;
+        }
+      }
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    _Event_Client _Clients [ EVENT_CLIENTS ] ;
+    int           _N              = 0 ;
+    unsigned long _Last_Keepalive = 0 ;
+
+    // ***********************************************************************
+    // All or nothing, returns false if the queue has no room
+    // ***********************************************************************
+    bool _Push ( _Event_Client &C, const char *Data, int Len ) {
+      if ( C.Len + Len > EVENT_QUEUE_SIZE ) {
+        return false ;
+      }
+      for ( int i = 0; i < Len; i++ ) {
+        C.Queue [ ( C.First + C.Len + i ) % EVENT_QUEUE_SIZE ] = Data [i] ;
+      }
+      C.Len += Len ;
+      return true ;
+    }
+
+    void _Drop ( _Event_Client &C ) {
+      C.Client.stop () ;
+      C.Client = WiFiClient () ;
+      C.Used   = false ;
+      _N      -= 1 ;
+    }
+} ;
+
+#endif
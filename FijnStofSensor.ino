@@ -5,21 +5,43 @@
 //    - millis counters are unsigned long, for which yields
 //         4294967295/(1000*60*60*24) = 49.7103 dagen
 //         so after about 50 days, none of the loops will be entered anymore
-//    - IP-address (or at least the last part), store it in RTC memory (inifile is also possible)
 //    - as soon as a second sensor is added, dynamically select available sensors
 //    - support of other API's
-//    - Web Interface
 //    - store/recover all settings via inifile
 //    - min/max bug uitzoeken ("not definied in this scope" ??? )
 //    - merge of verbose and debug_out
 //    - reprogram the device through wifi: #include <ArduinoOTA.h>
 //
+// Version 0.2, 18-10-2026, SM
+//    - MQTT broker failover list, the two best brokers are raced
+//    - MQTT-SN over UDP as alternative for MQTT ( SEND2MQTTSN )
+//    - sensors are selected at compile time by the *_READ flags
+//    - SDS011 driver mode selected by SDS_MODE
+//    - SDS011 commands are asynchronous, setup doesn't block anymore
+//    - SDS011 on SoftwareSerial or hardware UART ( SDS_SERIAL )
+//    - more SDS011 sensors on one node ( SDS_COUNT )
+//    - adaptive SDS011 duty cycle ( SDS_ADAPTIVE ), laser on-time in MQTT message
+//    - burst mode, samples published during a pollution spike ( SDS_BURST )
+//    - outlier rejection, rejected samples in MQTT message ( SDS_OUTLIER_FILTER )
+//    - on-device history, readable over MQTT ( HISTORY )
+//    - deep sleep during the pause of the SDS011, state in RTC memory ( DEEP_SLEEP )
+//    - fast Wi-Fi connect with the cached access point and IP, time to connect in MQTT message
+//    - radio only on during the upload windows ( RADIO_DUTY_CYCLE ), on-time in MQTT message
+//    - main loop idles until the next deadline ( IDLE ), CPU duty cycle and current in MQTT message
+//    - non-blocking web interface ( WEB_SERVER )
+//    - web templates split in segments at startup, rendering without searching placeholders
+//    - web logo sent pre-compressed from flash, with ETag and 304 Not Modified
+//    - live view of the samples in the browser, with Server-Sent Events ( /live )
+//    - binary history over HTTP ( /history ), charts drawn in the browser ( /history.html )
+//    - internal metrics in the Prometheus text format ( /metrics ), upload statistics per endpoint
+//    - latency histograms of the stages of the main loop, over MQTT or serial ( LOOP_TIMING )
+//
 // Version 0.1, 23-04-2018, SM, checked by RM
 //    - initial version
 //    - only supports SDS011, with outputs to Luftdaten, Madavi, MQTT
 // ***********************************************************************************
-String _FijnStofSensor_Version      = "0.1" ;
-String _FijnStofSensor_Version_Date = "25-04-2018" ;
+String _FijnStofSensor_Version      = "0.2" ;
+String _FijnStofSensor_Version_Date = "18-10-2026" ;
 String _FijnStofSensor_Version_By   = "SM" ;
 // ***********************************************************************************
 
@@ -56,6 +78,9 @@ uint8_t My_IP_Address [] = {192, 168,0,10} ;       // LOLIN + SDS011 semsor
 String MQTT_ID          = "FijnStof_2" ;
 String Subscription     = "prefix/" + MQTT_ID ;
 String Subscription_Out = Subscription + "_" ;          
+String Subscription_Burst = Subscription_Out + "/burst" ;   // samples during a pollution spike
+String Subscription_History = Subscription_Out + "/history" ; // pages of the on-device history
+String Subscription_Timing = Subscription_Out + "/timing" ;   // latency histograms of the main loop
 String LWT              = "\"$$Dead " + MQTT_ID + "\"" ;
 //String ALIVE            = "\"$$Alive " + MQTT_ID + "\"" ;
 String Version          = "Fijnstof V 0.1" ;
@@ -64,23 +89,186 @@ String Version          = "Fijnstof V 0.1" ;
 //  GLOBALS
 // *************************************************************************
 WiFiClient espClient ;
+WiFiClient espClient_Race ;       // second connection, to race the two best brokers
 PubSubClient client ( espClient ) ;
 
+#include "Loop_Timing.h"
 #include "My_Wifi.h" ;
 
+// ***********************************************************
+// MQTT-SN over UDP, a low overhead alternative for MQTT
+//   no connection has to be maintained, publish is QoS -1
+// ***********************************************************
+#if SEND2MQTTSN
+#include <WiFiUdp.h>
+#include "MQTT_SN.h"
+WiFiUDP  espUDP ;
+_MQTT_SN mqttsn ( espUDP ) ;
+#endif
+
 char msg[1000] ;
 
 
 
-// ************************************************
-// Create an instance of the SDS011 particle sensor
-// This class requires a soft serial port, 
-//   so you have to specify the hardware pins
-// ************************************************
-const int  RX = D1 ;  
-const int  TX = D2 ;
+// ***********************************************************************
+// All sensors on this node, selected by the *_READ flags in ext_def.h
+// Sensors that are not selected are not instantiated at all.
+// The SDS011 particle sensor uses a soft serial port or the hardware UART,
+//   selected by SDS_SERIAL, the soft serial pins are SDS_PIN_RX and SDS_PIN_TX in ext_def.h
+// More SDS011 sensors are selected by SDS_COUNT
+// ***********************************************************************
 #include "Sensor_SDS011.h"
-_Sensor_SDS011 Sensor_1 ( RX, TX ) ;
+#include "Sensor_Registry.h"
+typedef _Sensor_Registry <
+  _Sensor_If < SDS_READ,                      _Sensor_SDS011_N < 0 > >::type,
+  _Sensor_If < SDS_READ && ( SDS_COUNT > 1 ), _Sensor_SDS011_N < 1 > >::type,
+  _Sensor_If < SDS_READ && ( SDS_COUNT > 2 ), _Sensor_SDS011_N < 2 > >::type
+> _Sensors ;
+_Sensors Sensors ;
+
+// ***********************************************************************
+// On-device history of the first SDS011, see History.h
+// ***********************************************************************
+#if HISTORY
+_History History ;
+#endif
+
+// ***********************************************************************
+//  Global Parameters for the main loop
+// ***********************************************************************
+unsigned long Send_Last_Time     = 0 ;
+int           Send_Sample_Period = 150000 ;
+
+unsigned long Sample_Count = 0 ;         // loop iterations ( wake-ups when IDLE is used )
+unsigned long Radio_Window_Start = 0 ;
+unsigned long Idle_ms          = 0 ;     // idle time since the last send
+unsigned long Duty_Start       = 0 ;
+
+
+// ***********************************************************************
+// Upload counters, kept in RTC memory during deep sleep
+// ***********************************************************************
+unsigned long Send_Sequence = 0 ;         // number of sent messages
+unsigned long Send_Failed   = 0 ;         // number of messages that couldn't be sent
+
+// ***********************************************************************
+// Statistics per endpoint, see Metrics.h
+// ***********************************************************************
+#include "Metrics.h"
+#define UPLOAD_LUFTDATEN  0
+#define UPLOAD_MADAVI     1
+#define UPLOAD_MQTT       2
+#define UPLOAD_ENDPOINTS  3
+_Upload_Stats Uploads [ UPLOAD_ENDPOINTS ] = { "luftdaten", "madavi", "mqtt" } ;
+
+
+// ***********************************************************************
+// Web interface, see Web_Pages.h
+// ***********************************************************************
+#if WEB_SERVER
+#include "Web_Pages.h"
+#endif
+
+
+// ***********************************************************************
+// During a pollution spike ( SDS_BURST ), every sample is published
+//   [ "prefix", millis, PM2.5, PM10 ]
+// no reconnect here, that would block the sampling
+// ***********************************************************************
+void Burst_Sample ( _Sensor_SDS011 &Sensor ) {
+  char Burst_Msg [ 80 ] ;
+  sprintf ( Burst_Msg, "[\"%s\",%lu,%.1f,%.1f]", Sensor.Get_JSON_Prefix ().c_str (), millis (),
+                       0.1 * Sensor.PM_2_5, 0.1 * Sensor.PM_10 ) ;
+#if SEND2MQTTSN
+  mqttsn.publish ( Subscription_Burst.c_str(), Burst_Msg ) ;
+#else
+  if ( client.connected() ) {
+    client.publish ( Subscription_Burst.c_str(), Burst_Msg ) ;
+  }
+#endif
+}
+
+
+// ***********************************************************************
+// Requests on the input topic
+//   "history,<level>,<age>,<n>" : a page of the history is published on
+//                                 Subscription_History, see _History::Get_JSON
+//   "timing"                     : the latency histograms of the main loop are published on
+//                                 Subscription_Timing, see _Loop_Timing::Get_JSON
+//   "timing,reset"               : clears the latency histograms
+// ***********************************************************************
+void MQTT_Callback ( char* Topic, uint8_t* Payload, unsigned int Length ) {
+  char Request [ 40 ] ;
+  Length = min ( Length, (unsigned int) sizeof ( Request ) - 1 ) ;
+  memcpy ( Request, Payload, Length ) ;
+  Request [ Length ] = 0 ;
+
+#if HISTORY
+  int Level, Age, N ;
+  if ( sscanf ( Request, "history,%d,%d,%d", &Level, &Age, &N ) == 3 ) {
+    // room for the MQTT header and the topic
+    History.Get_JSON ( Level, Age, N, msg, MQTT_MAX_PACKET_SIZE - 100 ) ;
+    client.publish ( Subscription_History.c_str(), msg ) ;
+  }
+#endif
+#if LOOP_TIMING
+  if ( strcmp ( Request, "timing" ) == 0 ) {
+    Loop_Timing.Get_JSON ( msg, MQTT_MAX_PACKET_SIZE - 100 ) ;
+    client.publish ( Subscription_Timing.c_str(), msg ) ;
+  }
+  else if ( strcmp ( Request, "timing,reset" ) == 0 ) {
+    Loop_Timing.Reset () ;
+  }
+#endif
+}
+
+
+#if DEEP_SLEEP
+#if ( SDS_COUNT > 1 ) || ( SDS_MODE == SDS011_MODE_PERIOD )
+#error "DEEP_SLEEP needs 1 SDS011, not in working period mode"
+#endif
+
+// ***********************************************************************
+// Deep sleep, the state is kept in RTC memory, see RTC_State.h
+//   GPIO16 ( D0 ) must be connected to RST, to wake up
+// After the wake-up, the ESP starts again with setup
+// The MQTT session and Wi-Fi are closed first ( as in Radio_Off ),
+//   so the broker doesn't publish the LWT and the AP drops the station at once
+// ***********************************************************************
+void Deep_Sleep ( unsigned long Sleep_ms ) {
+  RTC_State.Add_Cycle ( millis (), Sleep_ms ) ;
+  RTC_State.Data.Send_Sequence   = Send_Sequence ;
+  RTC_State.Data.Send_Failed     = Send_Failed ;
+  Sensors.Get < _Sensor_SDS011_N < 0 > > ().Save_State ( RTC_State.Data.SDS ) ;
+  RTC_State.Write () ;
+
+  if ( client.connected() ) {
+    client.disconnect () ;
+  }
+  WiFi.disconnect () ;
+
+  sprintf ( msg, "Deep sleep %lu ms", Sleep_ms ) ;
+  debug_out ( msg, DEBUG_MIN_INFO, true ) ;
+  DEBUG_SERIAL.flush () ;
+  ESP.deepSleep ( 1000ULL * Sleep_ms, RF_DEFAULT ) ;
+}
+
+// ***********************************************************************
+// Energy budget of the ESP, from the awake and sleep times in RTC memory
+//   ( the SDS011 itself is not included )
+// ***********************************************************************
+void Print_Energy_Budget () {
+  float Awake_s = 0.001 * RTC_State.Data.Awake_ms_Total ;
+  float Sleep_s = 0.001 * RTC_State.Data.Sleep_ms_Total ;
+  if ( Awake_s + Sleep_s <= 0 ) {
+    return ;
+  }
+  sprintf ( msg, "Boot %u, awake %.0f s, sleep %.0f s, duty cycle %.1f %%, mean current %.2f mA",
+                 RTC_State.Data.Boot_Count, Awake_s, Sleep_s, 100 * RTC_State.Duty_Cycle (),
+                 RTC_State.Mean_Current_mA ( DEEP_SLEEP_AWAKE_MA, DEEP_SLEEP_SLEEP_MA ) ) ;
+  debug_out ( msg, DEBUG_MIN_INFO, true ) ;
+}
+#endif
 
 
 // ***********************************************************************
@@ -90,25 +278,57 @@ void setup() {
   
   // ***********************************************************************************
   // Open hardware serial communication port (USB connection) and wait for port to open:
+  // ( Serial1 if the hardware UART is used by the SDS011, see SDS_SERIAL )
   // ***********************************************************************************
-  Serial.begin ( 115200 ) ;
-  while ( !Serial ) {
+  DEBUG_SERIAL.begin ( 115200 ) ;
+  while ( !DEBUG_SERIAL ) {
     ; // wait for serial port to connect. Needed for native USB port only
   }
 
+  //******************************************************
+  // Restore the state after a deep sleep, see RTC_State.h
+  //******************************************************
+  bool RTC_Valid = RTC_State.Read () ;
+  RTC_State.Data.Boot_Count += 1 ;
+#if DEEP_SLEEP
+  if ( RTC_Valid ) {
+    Send_Sequence = RTC_State.Data.Send_Sequence ;
+    Send_Failed   = RTC_State.Data.Send_Failed ;
+    Sensors.Get < _Sensor_SDS011_N < 0 > > ().Restore_State ( RTC_State.Data.SDS ) ;
+    Print_Energy_Budget () ;
+  }
+#endif
+
   //******************************************************
   // Connect to MQTT broker
   //******************************************************
+  client.setRaceClient ( espClient_Race ) ;
+  MQTT_Brokers () ;
   Wifi_Connect ( My_IP_Address ) ;
+#if SEND2MQTTSN
+  mqttsn.setServer ( MQTTSN_Gateway_IP, MQTTSN_Gateway_Port ) ;
+  mqttsn.Add_Topic ( Subscription_Out.c_str(),   MQTTSN_Topic_ID ) ;
+  mqttsn.Add_Topic ( Subscription_Burst.c_str(), MQTTSN_Topic_ID + 1 ) ;
+#else
   if ( WiFi.status() == WL_CONNECTED ) {
     MQTT_Connect () ;
   }
-
-  // *************************
-  // get version, what for ???
-  // *************************
-  String Version_ID = Sensor_1.Get_Version ();
-  //Serial.println ( Version_ID ) ;
+#endif
+
+  SDS011_Burst_Callback = Burst_Sample ;
+#if WEB_SERVER
+  Web.Set_Stream ( "/events", &Web_Events ) ;
+  Web.begin () ;
+  SDS011_Sample_Callback = Web_Stream_Sample ;
+  SDS011_Window_Callback = Web_Stream_Window ;
+#endif
+#if IDLE && IDLE_LIGHT_SLEEP
+  WiFi.setSleepMode ( WIFI_LIGHT_SLEEP ) ;
+#endif
+  client.setCallback ( MQTT_Callback ) ;
+#if HISTORY && SDS_READ
+  Sensors.Get < _Sensor_SDS011_N < 0 > > ().History = &History ;
+#endif
 
   // ***************************************************
   // get chipid, needed for sending data to web api's
@@ -119,18 +339,173 @@ void setup() {
   // **************************************************
   // print header fro the CSV output on the serial port
   // **************************************************
-  sprintf ( msg, "\n\nMillis\tN\tPM2.5\tPM10\tSD_2.5\tSD_10\tmin2_5\tmax2_5\tmin_10\tmax_10\tB1_2.5\tB1_10" ) ;
+  sprintf ( msg, "\n\nMillis\tN\tReject\tPM2.5\tPM10\tSD_2.5\tSD_10\tmin2_5\tmax2_5\tmin_10\tmax_10\tB1_2.5\tB1_10" ) ;
   debug_out ( msg, DEBUG_WARNING, true );
 }
 
 
 // ***********************************************************************
-//  Global Parameters for the main loop
+//  Send the data of all sensors to all the api's
 // ***********************************************************************
-unsigned long Send_Last_Time     = 0 ;
-int           Send_Sample_Period = 150000 ;
+void Send_Data () {
+  String SDS = Sensors.Get_JSON_Data () ;
+
+  // ********************************************
+  // Luftdaten, each sensor is sent separately
+  //   ( only the first SDS011 )
+  // ********************************************
+#if SDS_READ
+  _Sensor_SDS011 &SDS_1 = Sensors.Get < _Sensor_SDS011_N < 0 > > () ;
+  String SDS_1_Data = SDS_1.Get_JSON_Data () ;
+  if ( SDS_1_Data.length () > 0 ) {
+    LOOP_TIME ( STAGE_LUFTDATEN ) ;
+    unsigned long Upload_Start = millis () ;
+    bool OK = sendLuftdaten ( SDS_1_Data, SDS_API_PIN, host_dusti, httpPort_dusti, url_dusti, SDS_1.Get_JSON_Prefix ().c_str () );
+    Uploads [ UPLOAD_LUFTDATEN ].Add ( OK, millis () - Upload_Start ) ;
+  }
+#endif
+
+  // ********************************************************
+  // for all other API's we need to construct a total message
+  // ********************************************************
+  String data ;
+  String data_sample_times ;
+  int    signal_strength = WiFi.RSSI();
+
+  // **********************************************
+  // don't know what the function of micros is ????
+  // **********************************************
+  data_sample_times  = Value2Json("samples", String(  long ( Sample_Count )));
+  //data_sample_times += Value2Json("min_micro", String(long(min_micro)));
+  //data_sample_times += Value2Json("max_micro", String(long(max_micro)));
+  data_sample_times += Value2Json ( "signal", String(signal_strength) );
+  
+  data = data_first_part;
+  data += SDS ;
+  data += data_sample_times;
+
+  // **********************
+  // remove the final comma
+  // **********************
+  //if ( data [ data.length() - 1 ] == "," ) {   //ERROR: ISO C++ forbids comparison between pointer and integer [-fpermissive]
+  if ( data.lastIndexOf (',') == ( data.length() - 1 ) ) {
+    data.remove(data.length() - 1);
+  }
+  data += "]}";
+  
+  // ********************************************
+  // MADAVI
+  // ********************************************
+  unsigned long Upload_Start = millis () ;
+  bool OK ;
+  {
+    LOOP_TIME ( STAGE_MADAVI ) ;
+    OK = sendData(data, 0, host_madavi, httpPort_madavi, url_madavi, "", FPSTR(TXT_CONTENT_TYPE_JSON));
+  }
+  Uploads [ UPLOAD_MADAVI ].Add ( OK, millis () - Upload_Start ) ;
+
+  // **********************
+  // send it to MQTT broker
+  // **********************
+  // laser on-time of the first SDS011 in seconds, to follow the laser lifetime
+  // and the number of rejected samples in the last working period
+  // and the time of the last Wi-Fi connect and the radio on-time in the last hour
+  // and the CPU duty cycle and estimated current since the last send
+  unsigned long Laser_On_s = 0 ;
+  int           Rejected   = 0 ;
+#if SDS_READ
+  Laser_On_s = Sensors.Get < _Sensor_SDS011_N < 0 > > ().Laser_On_s ;
+  Rejected   = Sensors.Get < _Sensor_SDS011_N < 0 > > ().Rejected ;
+#endif
+  unsigned long Duty_Period = max ( millis () - Duty_Start, 1UL ) ;
+  unsigned long Idle_Part   = min ( Idle_ms, Duty_Period ) ;
+  float CPU_Duty   = 100.0 * ( Duty_Period - Idle_Part ) / Duty_Period ;
+  float Current_mA = ( IDLE_ACTIVE_MA * ( Duty_Period - Idle_Part ) + IDLE_SLEEP_MA * Idle_Part ) / Duty_Period ;
+  Duty_Start = millis () ;
+  Idle_ms    = 0 ;
+
+  Send_Sequence += 1 ;
+  sprintf ( msg, "[%s,\"%s\",%d,%d,%lu,%d,%lu,%lu,%.1f,%.1f]", \
+                 SDS.c_str(), \
+                 Version.c_str(), \
+                 WiFi.RSSI(), ESP.getFreeHeap(), Laser_On_s, Rejected, Wifi_Connect_ms, Radio_On_Hour_ms / 1000, \
+                 CPU_Duty, Current_mA ) ;
+  Upload_Start = millis () ;
+#if SEND2MQTTSN
+  // ********************************************************************
+  // MQTT-SN is connectionless, so just fire and forget
+  // ********************************************************************
+  {
+    LOOP_TIME ( STAGE_MQTT_PUBLISH ) ;
+    OK = mqttsn.publish ( Subscription_Out.c_str(), msg ) ;
+  }
+#else
+  // ********************************************************************               
+  // MQTT connection will sometimes get lost, so if necessairy, reconnect
+  // ********************************************************************               
+  if ( ! client.connected() ) {
+    MQTT_Connect () ;
+  }
+  {
+    LOOP_TIME ( STAGE_MQTT_PUBLISH ) ;
+    OK = client.connected() && client.publish ( Subscription_Out.c_str(), msg ) ;
+  }
+#endif
+  if ( ! OK ) {
+    Send_Failed += 1 ;
+  }
+  Uploads [ UPLOAD_MQTT ].Add ( OK, millis () - Upload_Start ) ;
+}
 
-unsigned long Sample_Count = 0 ;
+
+// ***********************************************************************
+// The earliest deadline of the sensors, the uploads and the radio window,
+//   at most IDLE_MAX_MS, so MQTT requests and keep-alive are handled in time
+// ***********************************************************************
+unsigned long Next_Deadline_ms ( unsigned long Now ) {
+#if WEB_SERVER
+  if ( Web.Busy () ) {
+    return 0 ;
+  }
+#endif
+  unsigned long Next = min ( Sensors.Next_Event_ms ( Now ), (unsigned long) IDLE_MAX_MS ) ;
+#if ! DEEP_SLEEP
+  Next = min ( Next, Remaining_ms ( Now, Send_Last_Time, Send_Sample_Period ) ) ;
+#if RADIO_DUTY_CYCLE
+  if ( Radio_Is_On ) {
+    Next = min ( Next, Remaining_ms ( Now, Radio_Window_Start, RADIO_WINDOW_MS ) ) ;
+  }
+#endif
+#endif
+  return Next ;
+}
+
+// ***********************************************************************
+// Idle until the deadline, or until a sensor has received data,
+//   or a MQTT request is received.
+// delay lets the SDK idle the CPU ( and the modem in light sleep,
+//   see IDLE_LIGHT_SLEEP ), the conditions are checked every IDLE_STEP_MS
+// ***********************************************************************
+void Idle ( unsigned long Max_ms ) {
+  unsigned long Start = millis () ;
+  while ( ( millis () - Start ) < Max_ms ) {
+    if ( Sensors.Next_Event_ms ( millis () ) == 0 ) {
+      break ;
+    }
+#if WEB_SERVER
+    if ( Web.Busy () ) {
+      break ;
+    }
+#endif
+#if ! SEND2MQTTSN
+    if ( client.available () > 0 ) {
+      break ;
+    }
+#endif
+    delay ( IDLE_STEP_MS ) ;
+  }
+  Idle_ms += millis () - Start ;
+}
 
 
 // ***********************************************************************
@@ -143,6 +518,9 @@ void loop() {
   // ************************************************
   unsigned long Now = millis() ;
   Sample_Count     += 1 ;
+#if LOOP_TIMING
+  unsigned long Loop_Start_us = micros () ;
+#endif
 
   // *********************************************
   //  Ensure we've low info during continuous loop
@@ -154,70 +532,95 @@ void loop() {
   // Let all the sensor modules do their work 
   // should preferable be called at least once a second
   // **************************************************
-  Sensor_1.loop () ;
+  {
+    LOOP_TIME ( STAGE_SENSORS ) ;
+    Sensors.loop () ;
+  }
+#if HISTORY
+  {
+    LOOP_TIME ( STAGE_HISTORY ) ;
+    History.loop ( Now ) ;
+  }
+#endif
+#if WEB_SERVER
+  {
+    LOOP_TIME ( STAGE_WEB ) ;
+    Web.loop () ;
+    Web_Events.loop ( Now ) ;
+  }
+#endif
+#if ! SEND2MQTTSN
+  // handle the requests on the input topic
+  if ( client.connected() ) {
+    LOOP_TIME ( STAGE_MQTT_LOOP ) ;
+    client.loop () ;
+  }
+#endif
 
   // ***************************************************
   // Test if it's time to send new data to all the api's
   // ***************************************************
+#if DEEP_SLEEP
+  // ***********************************************************************
+  // In deep sleep mode, the data is sent after each working period,
+  //   and the ESP sleeps for the rest of the pause
+  // ***********************************************************************
+  _Sensor_SDS011 &SDS_Sleep = Sensors.Get < _Sensor_SDS011_N < 0 > > () ;
+  if ( ( SDS_Sleep.Window_Count > 0 ) && SDS_Sleep.Sleeping () && ! SDS_Sleep.Commands_Pending () ) {
+    Send_Data () ;
+    Deep_Sleep ( SDS_Sleep.Pause_Remaining_ms ( millis () ) ) ;
+  }
+#else
   if ( ( Now - Send_Last_Time ) > Send_Sample_Period ) {
     Send_Last_Time += Send_Sample_Period ; 
-
-    String SDS = Sensor_1.Get_JSON_Data () ;
-
-    // ********************************************
-    // Luftdaten
-    // ********************************************
-    sendLuftdaten ( SDS, SDS_API_PIN, host_dusti, httpPort_dusti, url_dusti, "SDS_");
-
-    // ********************************************************
-    // for all other API's we need to construct a total message
-    // ********************************************************
-    String data ;
-    String data_sample_times ;
-    int    signal_strength = WiFi.RSSI();
-
-    // **********************************************
-    // don't know what the function of micros is ????
-    // **********************************************
-    data_sample_times  = Value2Json("samples", String(  long ( Sample_Count )));
-    //data_sample_times += Value2Json("min_micro", String(long(min_micro)));
-    //data_sample_times += Value2Json("max_micro", String(long(max_micro)));
-    data_sample_times += Value2Json ( "signal", String(signal_strength) );
-    
-    data = data_first_part;
-    data += SDS ;
-    data += data_sample_times;
-
-    // **********************
-    // remove the final comma
-    // **********************
-    //if ( data [ data.length() - 1 ] == "," ) {   //ERROR: ISO C++ forbids comparison between pointer and integer [-fpermissive]
-    if ( data.lastIndexOf (',') == ( data.length() - 1 ) ) {
-      data.remove(data.length() - 1);
-    }
-    data += "]}";
-    
-    // ********************************************
-    // MADAVI
-    // ********************************************
-    sendData(data, 0, host_madavi, httpPort_madavi, url_madavi, "", FPSTR(TXT_CONTENT_TYPE_JSON));
-
-    // **********************
-    // send it to MQTT broker
-    // **********************
-    sprintf ( msg, "[%s,\"%s\",%d,%d]", \
-                   SDS.c_str(), \
-                   Version.c_str(), \
-                   WiFi.RSSI(), ESP.getFreeHeap() ) ;
-    // ********************************************************************               
-    // MQTT connection will sometimes get lost, so if necessairy, reconnect
-    // ********************************************************************               
-    if ( ! client.connected() ) {
-      MQTT_Connect () ;
-    }
-    if ( client.connected() ) {
-      client.publish ( Subscription_Out.c_str(), msg ) ;
-    }
+#if RADIO_DUTY_CYCLE
+    Radio_Window_Start = Now ;
+    Radio_On ( My_IP_Address ) ;
+#endif
+    Send_Data () ;
+  }
+#endif
+
+#if RADIO_DUTY_CYCLE && ! DEEP_SLEEP
+  // ***********************************************************************
+  // The radio is only on during the upload window ( RADIO_WINDOW_MS,
+  //   long enough to handle requests on the input topic ) and during a burst
+  // ***********************************************************************
+  bool Radio_Needed = ( millis () - Radio_Window_Start ) < RADIO_WINDOW_MS ;
+#if SDS_READ
+  Radio_Needed = Radio_Needed || Sensors.Get < _Sensor_SDS011_N < 0 > > ().Burst ;
+#endif
+  if ( Radio_Needed && ! Radio_Is_On ) {
+    Radio_On ( My_IP_Address ) ;
+#if ! SEND2MQTTSN
+    MQTT_Connect () ;
+#endif
   }
+  else if ( ! Radio_Needed && Radio_Is_On ) {
+    Radio_Off () ;
+  }
+#endif
+  Radio_loop ( Now ) ;
+
+#if LOOP_TIMING
+  // ***********************************************************************
+  // the complete loop, without the idle time,
+  //   a 't' on the serial port prints the latency histograms
+  //   ( not with SDS_SERIAL 1, Serial1 can only transmit )
+  // ***********************************************************************
+  Loop_Timing.Add ( STAGE_LOOP, micros () - Loop_Start_us ) ;
+#if SDS_SERIAL != 1
+  if ( DEBUG_SERIAL.available () && ( DEBUG_SERIAL.read () == 't' ) ) {
+    Loop_Timing.Print () ;
+  }
+#endif
+#endif
+
+#if IDLE
+  // ***********************************************************************
+  // nothing to do until the next deadline
+  // ***********************************************************************
+  Idle ( Next_Deadline_ms ( millis () ) ) ;
+#endif
 }
-
+
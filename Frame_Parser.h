@@ -0,0 +1,251 @@
+// ***********************************************************************************
+// This file implements a table driven parser for the binary UART frames
+//   of the dust sensors ( SDS011 and the Plantower PMS family ).
+//
+// Each protocol is described by a frame descriptor, a struct with only constants.
+// The parser is a template on that descriptor,
+//   so all protocol decisions are made at compile time
+//   and the parser itself doesn't allocate any memory.
+//
+// SDS011 :  AA C0|C5 d0 .. d5 ID1 ID2 CS AB
+//           fixed length 10, 8-bit sum over bytes 2..7, tail AB
+// PMSxxxx : 42 4D LenH LenL data .. SumH SumL
+//           length field = number of bytes after the length field,
+//           16-bit sum over all bytes before the checksum
+//           ( PMS3003 length = 20, PMS1003/PMS7003 length = 28 )
+//
+// When a frame is rejected ( bad tail, length or checksum ), its bytes after the first header byte
+//   are scanned again, so a frame that starts inside a truncated frame ( lost bytes ) is not lost.
+//
+// Public Functions implemented :
+//     bool Feed ( uint8_t kar ) {       // true if a complete and valid frame is received
+//     void Reset () {
+//     uint8_t Frame [..]                // the last valid frame
+//     int     Frame_Len                 // length of the last valid frame
+//     unsigned long Frames_OK, Checksum_Errors, Sync_Errors
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Frame_Parser_h
+#define _Frame_Parser_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version, SDS011 and Plantower frames
+//    - rejected frames are scanned again for the start of a frame
+// ***********************************************************************************
+String _Frame_Parser_Version      = "0.1" ;
+String _Frame_Parser_Version_Date = "18-10-2026" ;
+String _Frame_Parser_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+
+
+// ***********************************************************************************
+// Frame descriptor of the SDS011
+//   Header_1 = C0 for the measurement data, C5 for the reply on a command
+// ***********************************************************************************
+struct _Frame_SDS011 {
+  static constexpr uint8_t  Header_0     = 0xAA ;
+  static constexpr uint8_t  Header_1     = 0xC0 ;
+  static constexpr uint8_t  Header_1_Alt = 0xC5 ;
+  static constexpr bool     Length_Field = false ;
+  static constexpr uint8_t  Min_Length   = 10 ;
+  static constexpr uint8_t  Max_Length   = 10 ;
+  static constexpr uint8_t  Sum_First    = 2 ;
+  static constexpr uint8_t  Sum_Bytes    = 1 ;
+  static constexpr bool     Has_Tail     = true ;
+  static constexpr uint8_t  Tail         = 0xAB ;
+} ;
+
+// ***********************************************************************************
+// Frame descriptor of all Plantower sensors ( PMS3003, PMS1003, PMS7003 )
+// ***********************************************************************************
+struct _Frame_PMS {
+  static constexpr uint8_t  Header_0     = 0x42 ;
+  static constexpr uint8_t  Header_1     = 0x4D ;
+  static constexpr uint8_t  Header_1_Alt = 0x4D ;
+  static constexpr bool     Length_Field = true ;
+  static constexpr uint8_t  Min_Length   = 8 ;
+  static constexpr uint8_t  Max_Length   = 32 ;
+  static constexpr uint8_t  Sum_First    = 0 ;
+  static constexpr uint8_t  Sum_Bytes    = 2 ;
+  static constexpr bool     Has_Tail     = false ;
+  static constexpr uint8_t  Tail         = 0x00 ;
+} ;
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+template < typename Descriptor >
+class _Frame_Parser {
+
+  public:
+    uint8_t       Frame [ Descriptor::Max_Length ] ;
+    int           Frame_Len       = 0 ;
+    unsigned long Frames_OK       = 0 ;
+    unsigned long Checksum_Errors = 0 ;
+    unsigned long Sync_Errors     = 0 ;
+
+    // ***********************************************************************
+    // Feed the received bytes one by one.
+    // Returns true as soon as a complete and valid frame is in Frame.
+    // The frame stays valid until the next byte is fed.
+    // ***********************************************************************
+    bool Feed ( uint8_t kar ) {
+      if ( _Replay_N > 0 ) {
+        _Replay [ _Replay_N++ ] = kar ;
+        return _Feed_Replay () ;
+      }
+      if ( _Feed ( kar ) ) {
+        return true ;
+      }
+      return ( _Replay_N > 0 ) && _Feed_Replay () ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void Reset () {
+      _Pos        = 0 ;
+      _Expected   = Descriptor::Max_Length ;
+      _Replay_N   = 0 ;
+      _Replay_Pos = 0 ;
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    int     _Pos        = 0 ;
+    int     _Expected   = Descriptor::Max_Length ;
+    uint8_t _Replay [ 2 * Descriptor::Max_Length ] ;     // bytes to scan again
+    int     _Replay_N   = 0 ;
+    int     _Replay_Pos = 0 ;
+
+    // ***********************************************************************
+    // Scan the bytes of a rejected frame, a valid frame found there
+    //   is returned at once, the rest follows with the next bytes
+    // ***********************************************************************
+    bool _Feed_Replay () {
+      while ( _Replay_Pos < _Replay_N ) {
+        if ( _Feed ( _Replay [ _Replay_Pos++ ] ) ) {
+          if ( _Replay_Pos == _Replay_N ) {
+            _Replay_N   = 0 ;
+            _Replay_Pos = 0 ;
+          }
+          return true ;
+        }
+      }
+      _Replay_N   = 0 ;
+      _Replay_Pos = 0 ;
+      return false ;
+    }
+
+    // ***********************************************************************
+    // The frame of Len bytes is rejected, a new frame can only start
+    //   at a header byte after the first byte, those bytes are scanned again
+    //   ( before the bytes that are still waiting to be scanned )
+    // ***********************************************************************
+    void _Rescan ( int Len ) {
+      int First = 1 ;
+      while ( ( First < Len ) && ( Frame [ First ] != Descriptor::Header_0 ) ) {
+        First += 1 ;
+      }
+      int N    = Len - First ;
+      int Left = _Replay_N - _Replay_Pos ;
+      if ( ( N == 0 ) || ( N + Left > (int) sizeof ( _Replay ) ) ) {
+        return ;
+      }
+      memmove ( _Replay + N, _Replay + _Replay_Pos, Left ) ;
+      memcpy  ( _Replay, Frame + First, N ) ;
+      _Replay_Pos = 0 ;
+      _Replay_N   = N + Left ;
+    }
+
+    // ***********************************************************************
+    // The state machine of one frame
+    // ***********************************************************************
+    bool _Feed ( uint8_t kar ) {
+      switch ( _Pos ) {
+        case 0 :
+          if ( kar != Descriptor::Header_0 ) {
+            return false ;
+          }
+          break ;
+
+        case 1 :
+          if ( ( kar != Descriptor::Header_1 ) && ( kar != Descriptor::Header_1_Alt ) ) {
+            Sync_Errors += 1 ;
+            // *************************************
+            // this byte may be the start of a frame
+            // *************************************
+            _Pos = ( kar == Descriptor::Header_0 ) ? 1 : 0 ;
+            return false ;
+          }
+          break ;
+      }
+      Frame [ _Pos++ ] = kar ;
+
+      // ***************************************************
+      // when the length field is complete, check its value
+      // ***************************************************
+      if ( Descriptor::Length_Field && ( _Pos == 4 ) ) {
+        _Expected = 4 + 256 * Frame[2] + Frame[3] ;
+        if ( ( _Expected < Descriptor::Min_Length ) || ( _Expected > Descriptor::Max_Length ) ) {
+          Sync_Errors += 1 ;
+          _Pos      = 0 ;
+          _Expected = Descriptor::Max_Length ;
+          _Rescan ( 4 ) ;
+          return false ;
+        }
+      }
+
+      if ( _Pos < _Expected ) {
+        return false ;
+      }
+
+      // ***************************************
+      // the frame is complete, so validate it
+      // ***************************************
+      int Len = _Pos ;
+      _Pos      = 0 ;
+      _Expected = Descriptor::Max_Length ;
+      if ( Descriptor::Has_Tail && ( Frame [ Len - 1 ] != Descriptor::Tail ) ) {
+        Sync_Errors += 1 ;
+        _Rescan ( Len ) ;
+        return false ;
+      }
+      if ( ! _Check_Sum ( Len ) ) {
+        Checksum_Errors += 1 ;
+        _Rescan ( Len ) ;
+        return false ;
+      }
+      Frame_Len  = Len ;
+      Frames_OK += 1 ;
+      return true ;
+    }
+
+    // ***********************************************************************
+    // The checksum is just before the tail ( if any ),
+    //   it's the sum of all bytes from Sum_First up to the checksum
+    // ***********************************************************************
+    bool _Check_Sum ( int Len ) {
+      int      CS_Pos = Len - Descriptor::Sum_Bytes - ( Descriptor::Has_Tail ? 1 : 0 ) ;
+      uint16_t Sum    = 0 ;
+      for ( int i = Descriptor::Sum_First; i < CS_Pos; i++ ) {
+        Sum += Frame [i] ;
+      }
+      if ( Descriptor::Sum_Bytes == 1 ) {
+        return Frame [ CS_Pos ] == ( Sum & 0xFF ) ;
+      }
+      return ( 256 * Frame [ CS_Pos ] + Frame [ CS_Pos + 1 ] ) == Sum ;
+    }
+} ;
+
+#endif
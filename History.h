@@ -0,0 +1,252 @@
+// ***********************************************************************************
+// This file implements the on-device history of the PM values, in RAM.
+//
+// There are 3 rings with a different resolution :
+//     level 0 : 1 second,  HISTORY_N_SECONDS buckets
+//     level 1 : 1 minute,  HISTORY_N_MINUTES buckets
+//     level 2 : 1 hour,    HISTORY_N_HOURS   buckets
+// Each bucket holds the mean, min and max of PM2.5 and PM10 ( in 0.1 ug/m3 ),
+//   packed in 12 bytes. A period without any sample ( e.g. the sensor sleeps )
+//   is stored as a gap ( Mean_2_5 = HISTORY_GAP ).
+// The samples are added to all levels at once, so each level is exact
+//   and no raw samples have to be kept.
+//
+// The history can be read bucket by bucket ( Get ), or as a JSON page ( Get_JSON ),
+//   e.g. to backfill a dashboard after a broker outage.
+//
+// Public Functions implemented :
+//     void Add ( unsigned long Now, uint16_t PM_2_5, uint16_t PM_10 ) {
+//     void loop ( unsigned long Now ) {        // closes the buckets of which the period has passed
+//     int  Count ( int Level ) {               // number of closed buckets
+//     bool Get ( int Level, int Age, _History_Bucket &Bucket ) {   // Age = 0 is the newest bucket
+//     unsigned long Last_Time ( int Level ) {  // end time ( millis ) of the newest bucket
+//     int  Get_JSON ( int Level, int First_Age, int N, char *Buffer, int Size ) {   // newest first
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _History_h
+#define _History_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version, 3 levels ( second, minute, hour )
+// ***********************************************************************************
+String _History_Version      = "0.1" ;
+String _History_Version_Date = "18-10-2026" ;
+String _History_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+
+#define HISTORY_LEVELS      3
+#define HISTORY_N_SECONDS   120     // 2 minutes, about one working period
+#define HISTORY_N_MINUTES   120     // 2 hours
+#define HISTORY_N_HOURS     48      // 2 days
+#define HISTORY_GAP         0xFFFF
+
+// ***********************************************************************************
+// ***********************************************************************************
+struct _History_Bucket {
+  uint16_t Mean_2_5, Min_2_5, Max_2_5 ;
+  uint16_t Mean_10,  Min_10,  Max_10 ;
+} ;
+
+// ***********************************************************************************
+// One ring, with the accumulator of the bucket that's being filled
+// ***********************************************************************************
+struct _History_Ring {
+  _History_Bucket *Buckets ;
+  int              Size ;
+  unsigned long    Period_ms ;
+  int              First     = 0 ;      // oldest bucket
+  int              N         = 0 ;
+  unsigned long    Index     = 0 ;      // Now / Period_ms of the bucket being filled
+  uint32_t         Sum_2_5   = 0 ;
+  uint32_t         Sum_10    = 0 ;
+  uint16_t         N_Sample  = 0 ;
+  _History_Bucket  Open ;
+} ;
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _History {
+
+  public:
+    // ***********************************************************************
+    // ***********************************************************************
+    _History () {
+      _Init ( _Ring[0], _Seconds, HISTORY_N_SECONDS, 1000UL ) ;
+      _Init ( _Ring[1], _Minutes, HISTORY_N_MINUTES, 60000UL ) ;
+      _Init ( _Ring[2], _Hours,   HISTORY_N_HOURS,   3600000UL ) ;
+    }
+
+    // ***********************************************************************
+    // Add a sample ( in 0.1 ug/m3 ) to all levels
+    // ***********************************************************************
+    void Add ( unsigned long Now, uint16_t PM_2_5, uint16_t PM_10 ) {
+      for ( int Level = 0; Level < HISTORY_LEVELS; Level++ ) {
+        _History_Ring &Ring = _Ring [ Level ] ;
+        _Close ( Ring, Now ) ;
+        _History_Bucket &Open = Ring.Open ;
+        if ( Ring.N_Sample == 0 ) {
+          Open.Min_2_5 = Open.Max_2_5 = PM_2_5 ;
+          Open.Min_10  = Open.Max_10  = PM_10 ;
+        }
+        Open.Min_2_5  = min ( Open.Min_2_5, PM_2_5 ) ;
+        Open.Max_2_5  = max ( Open.Max_2_5, PM_2_5 ) ;
+        Open.Min_10   = min ( Open.Min_10,  PM_10  ) ;
+        Open.Max_10   = max ( Open.Max_10,  PM_10  ) ;
+        Ring.Sum_2_5 += PM_2_5 ;
+        Ring.Sum_10  += PM_10 ;
+        Ring.N_Sample += 1 ;
+      }
+    }
+
+    // ***********************************************************************
+    // Should be called regularly, so the last bucket is closed
+    //   even when no new samples arrive
+    // ***********************************************************************
+    void loop ( unsigned long Now ) {
+      for ( int Level = 0; Level < HISTORY_LEVELS; Level++ ) {
+        _Close ( _Ring [ Level ], Now ) ;
+      }
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    int Count ( int Level ) {
+      return _Ring [ Level ].N ;
+    }
+
+    unsigned long Period_ms ( int Level ) {
+      return _Ring [ Level ].Period_ms ;
+    }
+
+    unsigned long Last_Time ( int Level ) {
+      return _Ring [ Level ].Index * _Ring [ Level ].Period_ms ;
+    }
+
+    // ***********************************************************************
+    // Age = 0 is the newest closed bucket,
+    //   returns false if there's no such bucket or if the bucket is a gap
+    // ***********************************************************************
+    bool Get ( int Level, int Age, _History_Bucket &Bucket ) {
+      _History_Ring &Ring = _Ring [ Level ] ;
+      if ( ( Age < 0 ) || ( Age >= Ring.N ) ) {
+        return false ;
+      }
+      Bucket = Ring.Buckets [ ( Ring.First + Ring.N - 1 - Age ) % Ring.Size ] ;
+      return Bucket.Mean_2_5 != HISTORY_GAP ;
+    }
+
+    // ***********************************************************************
+    // A page of at most N buckets, from First_Age backwards in time, newest first :
+    //   {"level":1,"period":60,"age":5,"t":<end time of the newest bucket>,
+    //    "data":[[mean,min,max PM2.5,mean,min,max PM10],..,null,..],"n":<buckets>}
+    //   age = age of the first bucket in this page, values in 0.1 ug/m3
+    // The page stops early if the buffer is full, "n" tells how many buckets are sent,
+    //   so the next page starts at age + n
+    // Returns the number of bytes written ( without the closing zero )
+    // ***********************************************************************
+    int Get_JSON ( int Level, int First_Age, int N, char *Buffer, int Size ) {
+      if ( ( Level < 0 ) || ( Level >= HISTORY_LEVELS ) ) {
+        return snprintf ( Buffer, Size, "{\"error\":\"level\"}" ) ;
+      }
+      int Len = snprintf ( Buffer, Size, "{\"level\":%d,\"period\":%lu,\"age\":%d,\"t\":%lu,\"data\":[",
+                           Level, Period_ms ( Level ) / 1000, First_Age, Last_Time ( Level ) ) ;
+      int  Sent = 0 ;
+      char Item [ 48 ] ;
+      for ( int Age = First_Age; ( Age < First_Age + N ) && ( Age < Count ( Level ) ); Age++ ) {
+        _History_Bucket Bucket ;
+        const char *Sep = ( Sent == 0 ) ? "" : "," ;
+        int Item_Len ;
+        if ( Get ( Level, Age, Bucket ) ) {
+          Item_Len = snprintf ( Item, sizeof ( Item ), "%s[%u,%u,%u,%u,%u,%u]", Sep,
+                                Bucket.Mean_2_5, Bucket.Min_2_5, Bucket.Max_2_5,
+                                Bucket.Mean_10,  Bucket.Min_10,  Bucket.Max_10 ) ;
+        }
+        else {
+          Item_Len = snprintf ( Item, sizeof ( Item ), "%snull", Sep ) ;
+        }
+        // room for the item and the tail
+        if ( Len + Item_Len + 16 >= Size ) {
+          break ;
+        }
+        strcpy ( Buffer + Len, Item ) ;
+        Len  += Item_Len ;
+        Sent += 1 ;
+      }
+      Len += snprintf ( Buffer + Len, Size - Len, "],\"n\":%d}", Sent ) ;
+      return Len ;
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    _History_Ring   _Ring    [ HISTORY_LEVELS ] ;
+    _History_Bucket _Seconds [ HISTORY_N_SECONDS ] ;
+    _History_Bucket _Minutes [ HISTORY_N_MINUTES ] ;
+    _History_Bucket _Hours   [ HISTORY_N_HOURS ] ;
+
+    void _Init ( _History_Ring &Ring, _History_Bucket *Buckets, int Size, unsigned long Period_ms ) {
+      Ring.Buckets   = Buckets ;
+      Ring.Size      = Size ;
+      Ring.Period_ms = Period_ms ;
+    }
+
+    // ***********************************************************************
+    // Close the open bucket if its period has passed,
+    //   and add a gap for every period without samples ( at most a full ring )
+    // ***********************************************************************
+    void _Close ( _History_Ring &Ring, unsigned long Now ) {
+      unsigned long Index = Now / Ring.Period_ms ;
+      if ( Index == Ring.Index ) {
+        return ;
+      }
+      if ( Ring.N_Sample > 0 ) {
+        Ring.Open.Mean_2_5 = ( Ring.Sum_2_5 + Ring.N_Sample / 2 ) / Ring.N_Sample ;
+        Ring.Open.Mean_10  = ( Ring.Sum_10  + Ring.N_Sample / 2 ) / Ring.N_Sample ;
+        _Push ( Ring, Ring.Open ) ;
+      }
+      else if ( Ring.N > 0 ) {
+        _Push_Gap ( Ring ) ;
+      }
+      if ( Ring.N > 0 ) {
+        unsigned long Gaps = min ( Index - Ring.Index - 1, (unsigned long) Ring.Size ) ;
+        for ( unsigned long i = 0; i < Gaps; i++ ) {
+          _Push_Gap ( Ring ) ;
+        }
+      }
+      Ring.Index    = Index ;
+      Ring.Sum_2_5  = 0 ;
+      Ring.Sum_10   = 0 ;
+      Ring.N_Sample = 0 ;
+    }
+
+    void _Push_Gap ( _History_Ring &Ring ) {
+      _History_Bucket Gap ;
+      memset ( &Gap, 0, sizeof ( Gap ) ) ;
+      Gap.Mean_2_5 = HISTORY_GAP ;
+      _Push ( Ring, Gap ) ;
+    }
+
+    void _Push ( _History_Ring &Ring, const _History_Bucket &Bucket ) {
+      if ( Ring.N < Ring.Size ) {
+        Ring.Buckets [ ( Ring.First + Ring.N ) % Ring.Size ] = Bucket ;
+        Ring.N += 1 ;
+      }
+      else {
+        Ring.Buckets [ Ring.First ] = Bucket ;
+        Ring.First = ( Ring.First + 1 ) % Ring.Size ;
+      }
+    }
+} ;
+
+#endif
@@ -0,0 +1,201 @@
+// ***********************************************************************************
+// This file implements latency histograms for the stages of the main loop.
+//
+// A stage is timed by a scoped timer, from the LOOP_TIME macro to the end of the block :
+//     {
+//       LOOP_TIME ( STAGE_SENSORS ) ;
+//       Sensors.loop () ;
+//     }
+// Each duration ( in microseconds ) is counted in a histogram with logarithmic buckets,
+//   bucket k holds the durations from 2^k to 2^(k+1) us, so the memory is fixed
+//   and adding a duration is only a few instructions.
+// From the histogram the median ( p50 ), p99 and maximum are derived,
+//   p50 and p99 are the upper limit of their bucket ( at most a factor 2 too high ).
+//
+// With LOOP_TIMING = 0 ( ext_def.h ) the macro is empty and nothing is compiled in.
+//
+// Public Functions implemented :
+//     void Add ( int Stage, unsigned long Duration_us ) {
+//     int  Get_JSON ( char *Buffer, int Size ) {   // {"stage":[n,p50,p99,max],..} in us
+//     void Print () {                              // table on the serial port
+//     void Reset () {
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Loop_Timing_h
+#define _Loop_Timing_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version
+// ***********************************************************************************
+String _Loop_Timing_Version      = "0.1" ;
+String _Loop_Timing_Version_Date = "18-10-2026" ;
+String _Loop_Timing_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+
+#ifndef LOOP_TIMING
+#define LOOP_TIMING 0
+#endif
+
+// ***********************************************************************************
+// The stages
+// ***********************************************************************************
+#define STAGE_LOOP           0      // the complete loop, without the idle time
+#define STAGE_SENSORS        1
+#define STAGE_STATISTICS     2      // end of a working period of the SDS011
+#define STAGE_HISTORY        3
+#define STAGE_WEB            4
+#define STAGE_MQTT_LOOP      5
+#define STAGE_LUFTDATEN      6
+#define STAGE_MADAVI         7
+#define STAGE_MQTT_CONNECT   8
+#define STAGE_MQTT_PUBLISH   9
+#define STAGE_COUNT          10
+
+#define LOOP_TIMING_BUCKETS  24     // up to 2^24 us = 16.8 s
+
+#if LOOP_TIMING
+
+const char *const _Stage_Names [ STAGE_COUNT ] = {
+  "loop", "sensors", "statistics", "history", "web",
+  "mqtt_loop", "luftdaten", "madavi", "mqtt_connect", "mqtt_publish"
+} ;
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+struct _Latency_Histogram {
+  uint32_t Buckets [ LOOP_TIMING_BUCKETS ] ;
+  uint32_t N ;
+  uint32_t Max_us ;
+
+  // ***********************************************************************
+  // ***********************************************************************
+  void Add ( unsigned long Duration_us ) {
+    int Bucket = 0 ;
+    while ( ( Duration_us >> ( Bucket + 1 ) ) && ( Bucket < LOOP_TIMING_BUCKETS - 1 ) ) {
+      Bucket += 1 ;
+    }
+    Buckets [ Bucket ] += 1 ;
+    N += 1 ;
+    Max_us = max ( Max_us, (uint32_t) Duration_us ) ;
+  }
+
+  // ***********************************************************************
+  // Upper limit of the bucket that holds the Percent percentile,
+  //   not more than the maximum
+  // ***********************************************************************
+  uint32_t Percentile_us ( int Percent ) {
+    if ( N == 0 ) {
+      return 0 ;
+    }
+    uint32_t Rank  = ( (uint64_t) N * Percent + 99 ) / 100 ;
+    uint32_t Count = 0 ;
+    for ( int Bucket = 0; Bucket < LOOP_TIMING_BUCKETS; Bucket++ ) {
+      Count += Buckets [ Bucket ] ;
+      if ( Count >= Rank ) {
+        return min ( ( 2UL << Bucket ) - 1, (unsigned long) Max_us ) ;
+      }
+    }
+    return Max_us ;
+  }
+} ;
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _Loop_Timing {
+
+  public:
+    _Loop_Timing () {
+      Reset () ;
+    }
+
+    void Add ( int Stage, unsigned long Duration_us ) {
+      _Stages [ Stage ].Add ( Duration_us ) ;
+    }
+
+    void Reset () {
+      memset ( _Stages, 0, sizeof ( _Stages ) ) ;
+    }
+
+    // ***********************************************************************
+    // Only the stages that ran, returns the number of bytes written
+    // ***********************************************************************
+    int Get_JSON ( char *Buffer, int Size ) {
+      int Len = snprintf ( Buffer, Size, "{" ) ;
+      for ( int Stage = 0; ( Stage < STAGE_COUNT ) && ( Len < Size ); Stage++ ) {
+        _Latency_Histogram &H = _Stages [ Stage ] ;
+        if ( H.N == 0 ) {
+          continue ;
+        }
+        Len += snprintf ( Buffer + Len, Size - Len, "%s\"%s\":[%lu,%lu,%lu,%lu]", ( Len > 1 ) ? "," : "",
+                          _Stage_Names [ Stage ], (unsigned long) H.N, (unsigned long) H.Percentile_us ( 50 ),
+                          (unsigned long) H.Percentile_us ( 99 ), (unsigned long) H.Max_us ) ;
+      }
+      if ( Len < Size ) {
+        Len += snprintf ( Buffer + Len, Size - Len, "}" ) ;
+      }
+      return Len ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void Print () {
+      char Line [ 80 ] ;
+      DEBUG_SERIAL.println ( "stage                 N      p50 us      p99 us      max us" ) ;
+      for ( int Stage = 0; Stage < STAGE_COUNT; Stage++ ) {
+        _Latency_Histogram &H = _Stages [ Stage ] ;
+        snprintf ( Line, sizeof ( Line ), "%-14s %8lu %11lu %11lu %11lu", _Stage_Names [ Stage ],
+                   (unsigned long) H.N, (unsigned long) H.Percentile_us ( 50 ),
+                   (unsigned long) H.Percentile_us ( 99 ), (unsigned long) H.Max_us ) ;
+        DEBUG_SERIAL.println ( Line ) ;
+      }
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    _Latency_Histogram _Stages [ STAGE_COUNT ] ;
+} ;
+
+_Loop_Timing Loop_Timing ;
+
+
+// ***********************************************************************************
+// Adds the time from its construction to the end of the block
+// ***********************************************************************************
+class _Scoped_Timer {
+
+  public:
+    _Scoped_Timer ( int Stage ) : _Stage ( Stage ), _Start ( micros () ) {}
+
+    ~_Scoped_Timer () {
+      Loop_Timing.Add ( _Stage, micros () - _Start ) ;
+    }
+
+  private:
+    int           _Stage ;
+    unsigned long _Start ;
+} ;
+
+#define LOOP_TIME_NAME(Line)  _Loop_Timer_ ## Line
+#define LOOP_TIME_LINE(Line)  LOOP_TIME_NAME ( Line )
+#define LOOP_TIME(Stage)      _Scoped_Timer LOOP_TIME_LINE ( __LINE__ ) ( Stage )
+
+#else
+
+#define LOOP_TIME(Stage)
+
+#endif
+
+#endif
@@ -40,17 +40,17 @@ String Value2Json(const String& type, const String& value) {
 void debug_out(const String& text, const int level, const bool linebreak) {
   if (level <= debug) {
     if (linebreak) {
-      Serial.println(text);
+      DEBUG_SERIAL.println(text);
     } else {
-      Serial.print(text);
+      DEBUG_SERIAL.print(text);
     }
   }
 }
 
 /*****************************************************************
-/* send data to rest api                                         *
+/* send data to rest api, false if there's no connection         *
 /*****************************************************************/
-void sendData(const String& data, const int pin, const char* host, const int httpPort, const char* url, const char* basic_auth_string, const String& contentType) {
+bool sendData(const String& data, const int pin, const char* host, const int httpPort, const char* url, const char* basic_auth_string, const String& contentType) {
 #if defined(ESP8266)
 
   debug_out(F("Start connecting to "), DEBUG_MIN_INFO, 0);
@@ -76,7 +76,7 @@ void sendData(const String& data, const int pin, const char* host, const int htt
 
     if (!client_s.connect(host, httpPort)) {
       debug_out(F("connection failed"), DEBUG_ERROR, 1);
-      return;
+      return false;
     }
 
     debug_out(F("Requesting URL: "), DEBUG_MIN_INFO, 0);
@@ -109,7 +109,7 @@ void sendData(const String& data, const int pin, const char* host, const int htt
 
     if (!client.connect(host, httpPort)) {
       debug_out(F("connection failed"), DEBUG_ERROR, 1);
-      return;
+      return false;
     }
 
     debug_out(F("Requesting URL: "), DEBUG_MIN_INFO, 0);
@@ -138,6 +138,9 @@ void sendData(const String& data, const int pin, const char* host, const int htt
 
   wdt_reset(); // nodemcu is alive
   yield();
+  return true;
+#else
+  return false;
 #endif
 }
 
@@ -145,20 +148,21 @@ void sendData(const String& data, const int pin, const char* host, const int htt
 /*****************************************************************
 /* send single sensor data to luftdaten.info api                 *
 /*****************************************************************/
-void sendLuftdaten(const String& data, const int pin, const char* host, const int httpPort, const char* url, const char* replace_str) {
+bool sendLuftdaten(const String& data, const int pin, const char* host, const int httpPort, const char* url, const char* replace_str) {
   String data_4_dusti = "";
   data_4_dusti  = data_first_part + data;
   data_4_dusti.remove(data_4_dusti.length() - 1);
   data_4_dusti.replace(replace_str, "");
   data_4_dusti += "]}";
   if (data != "") {
-    sendData(data_4_dusti, pin, host, httpPort, url, "", FPSTR(TXT_CONTENT_TYPE_JSON));
+    return sendData(data_4_dusti, pin, host, httpPort, url, "", FPSTR(TXT_CONTENT_TYPE_JSON));
   } else {
     debug_out(F("No data sent..."), DEBUG_MIN_INFO, 1);
+    return false;
   }
 }
 
 
 
 
-#endif
+#endif
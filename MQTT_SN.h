@@ -0,0 +1,189 @@
+// ***********************************************************************************
+// This file implements a minimal MQTT-SN publisher over UDP.
+// It has the same publish-side API as PubSubClient,
+//   so it can be used instead of the MQTT publish in the main loop.
+//
+// Only QoS -1 is implemented: no CONNECT, no REGISTER, no acknowledgement,
+//   every publish is a single UDP datagram (fire and forget).
+// Because there's no REGISTER, the topics must be pre-defined in the gateway,
+//   with the same topic-ID's as given to Add_Topic.
+//
+// Public Functions implemented :
+//     _MQTT_SN ( WiFiUDP &UDP ) {                              // Constructor
+//     void    setServer ( const char* Gateway, uint16_t Port ) {
+//     bool    Add_Topic ( const char* Topic, uint16_t Topic_ID ) {
+//     boolean publish ( const char* topic, const char* payload ) {
+//     boolean publish ( const char* topic, const uint8_t* payload, unsigned int plength ) {
+//     boolean connected () {                                   // always true, UDP is connectionless
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _MQTT_SN_h
+#define _MQTT_SN_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version, QoS -1 publish with pre-defined topic-ID's
+// ***********************************************************************************
+String _MQTT_SN_Version      = "0.1" ;
+String _MQTT_SN_Version_Date = "18-10-2026" ;
+String _MQTT_SN_Version_By   = "SM" ;
+// ***********************************************************************************
+
+// ********************************
+// specific imports for this module
+// ********************************
+#include <Arduino.h>
+#include <WiFiUdp.h>
+
+// ***********************************************************************************
+// ***********************************************************************************
+#define MQTTSN_MAX_TOPICS        8
+#define MQTTSN_MAX_PACKET_SIZE   MQTT_MAX_PACKET_SIZE
+
+#define MQTTSN_PUBLISH           0x0C
+#define MQTTSN_FLAG_QOS_M1       0x60       // QoS -1
+#define MQTTSN_FLAG_RETAIN       0x10
+#define MQTTSN_TOPIC_PREDEFINED  0x01
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _MQTT_SN {
+
+  public:
+    unsigned long Publish_Count = 0 ;
+    unsigned long Publish_Error = 0 ;
+
+    // ***********************************************************************
+    // The UDP socket is provided by the user, so it can be shared
+    // ***********************************************************************
+    _MQTT_SN ( WiFiUDP &UDP ) {
+      _UDP = &UDP ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void setServer ( const char* Gateway, uint16_t Port ) {
+      _Gateway = Gateway ;
+      _Port    = Port ;
+    }
+
+    // ***********************************************************************
+    // Couple a topic name to a topic-ID that is pre-defined in the gateway.
+    // Returns false if the table is full.
+    // ***********************************************************************
+    bool Add_Topic ( const char* Topic, uint16_t Topic_ID ) {
+      if ( _N_Topic >= MQTTSN_MAX_TOPICS ) {
+        return false ;
+      }
+      _Topic    [ _N_Topic ] = Topic ;
+      _Topic_ID [ _N_Topic ] = Topic_ID ;
+      _N_Topic += 1 ;
+      return true ;
+    }
+
+    // ***********************************************************************
+    // Same as PubSubClient, UDP is connectionless, so we're always "connected"
+    // ***********************************************************************
+    boolean connected () {
+      return true ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    boolean publish ( const char* topic, const char* payload ) {
+      return publish ( topic, (const uint8_t*) payload, strlen ( payload ), false ) ;
+    }
+
+    boolean publish ( const char* topic, const char* payload, boolean retained ) {
+      return publish ( topic, (const uint8_t*) payload, strlen ( payload ), retained ) ;
+    }
+
+    boolean publish ( const char* topic, const uint8_t* payload, unsigned int plength ) {
+      return publish ( topic, payload, plength, false ) ;
+    }
+
+    // ***********************************************************************
+    // Publish with QoS -1
+    //   Length ( 1 or 3 bytes ), MsgType, Flags, TopicId (2), MsgId (2), Data
+    // ***********************************************************************
+    boolean publish ( const char* topic, const uint8_t* payload, unsigned int plength, boolean retained ) {
+      int Index = _Find_Topic ( topic ) ;
+      if ( ( Index < 0 ) || ( _Gateway == NULL ) ) {
+        Publish_Error += 1 ;
+        return false ;
+      }
+
+      // ***********************************************
+      // the length field is 3 bytes if larger than 255
+      // ***********************************************
+      unsigned int Length = 7 + plength ;
+      uint8_t      Header [ 9 ] ;
+      int          Pos = 0 ;
+      if ( Length > 255 ) {
+        Length += 2 ;
+        if ( Length > MQTTSN_MAX_PACKET_SIZE ) {
+          Publish_Error += 1 ;
+          return false ;
+        }
+        Header [ Pos++ ] = 0x01 ;
+        Header [ Pos++ ] = Length >> 8 ;
+        Header [ Pos++ ] = Length & 0xFF ;
+      }
+      else {
+        Header [ Pos++ ] = Length ;
+      }
+      Header [ Pos++ ] = MQTTSN_PUBLISH ;
+      Header [ Pos++ ] = MQTTSN_FLAG_QOS_M1 | MQTTSN_TOPIC_PREDEFINED | ( retained ? MQTTSN_FLAG_RETAIN : 0 ) ;
+      Header [ Pos++ ] = _Topic_ID [ Index ] >> 8 ;
+      Header [ Pos++ ] = _Topic_ID [ Index ] & 0xFF ;
+      Header [ Pos++ ] = 0x00 ;         // MsgId is not used with QoS -1
+      Header [ Pos++ ] = 0x00 ;
+
+      // **************************************************
+      // the payload is written directly, without a copy
+      // **************************************************
+      if ( ! _UDP->beginPacket ( _Gateway, _Port ) ) {
+        Publish_Error += 1 ;
+        return false ;
+      }
+      _UDP->write ( Header, Pos ) ;
+      _UDP->write ( payload, plength ) ;
+      if ( ! _UDP->endPacket () ) {
+        Publish_Error += 1 ;
+        return false ;
+      }
+      Publish_Count += 1 ;
+      return true ;
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    WiFiUDP      *_UDP ;
+    const char   *_Gateway = NULL ;
+    uint16_t      _Port    = 1883 ;
+    const char   *_Topic    [ MQTTSN_MAX_TOPICS ] ;
+    uint16_t      _Topic_ID [ MQTTSN_MAX_TOPICS ] ;
+    int           _N_Topic = 0 ;
+
+    // ***********************************************************************
+    // ***********************************************************************
+    int _Find_Topic ( const char* Topic ) {
+      for ( int i = 0; i < _N_Topic; i++ ) {
+        if ( strcmp ( _Topic [i], Topic ) == 0 ) {
+          return i ;
+        }
+      }
+      return -1 ;
+    }
+};
+
+#endif
@@ -0,0 +1,159 @@
+// ***********************************************************************************
+// This file implements the internal metrics of the node,
+//   in the Prometheus / OpenMetrics text format, for the /metrics page of the web interface.
+//
+// A metric is a name, a type, a help text and a function that writes its samples :
+//   the labels and the value of sample Index ( e.g. '{endpoint="mqtt"} 12' or ' 12' ),
+//   returns false if there's no such sample, so a metric can have any number of samples.
+//
+//   const _Metric Metrics [] = { { "node_uptime_seconds", "gauge", "Time since boot", Get_Uptime }, { NULL } } ;
+//
+// The page is written line by line in a small buffer, Fill continues where it stopped,
+//   so no String of the whole page is built.
+//
+// Also the statistics of the uploads ( _Upload_Stats ) are here.
+//
+// Public Functions implemented :
+//     void Start ( const _Metric *Metrics ) {
+//     int  Fill ( char *Out, int Size ) {       // 0 if the page is complete
+//     bool Metric_Value ( int Index, char *Buffer, int Size, unsigned long Value ) {   // a metric with 1 sample
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Metrics_h
+#define _Metrics_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version
+// ***********************************************************************************
+String _Metrics_Version      = "0.1" ;
+String _Metrics_Version_Date = "18-10-2026" ;
+String _Metrics_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+
+#define METRICS_LINE_SIZE    160
+
+// ***********************************************************************************
+// The list of metrics is closed by Name = NULL
+// ***********************************************************************************
+struct _Metric {
+  const char *Name ;
+  const char *Type ;
+  const char *Help ;
+  bool ( *Get ) ( int Index, char *Buffer, int Size ) ;
+} ;
+
+// ***********************************************************************************
+// For a metric without labels
+// ***********************************************************************************
+bool Metric_Value ( int Index, char *Buffer, int Size, unsigned long Value ) {
+  if ( Index > 0 ) {
+    return false ;
+  }
+  snprintf ( Buffer, Size, " %lu", Value ) ;
+  return true ;
+}
+
+
+// ***********************************************************************************
+// Statistics of the uploads to one endpoint
+// ***********************************************************************************
+struct _Upload_Stats {
+  const char   *Endpoint ;
+  unsigned long Attempts = 0 ;
+  unsigned long Failures = 0 ;
+  unsigned long Last_ms  = 0 ;          // duration of the last upload
+  unsigned long Total_ms = 0 ;          // of all uploads
+
+  _Upload_Stats ( const char *Name ) : Endpoint ( Name ) {}
+
+  void Add ( bool OK, unsigned long Duration_ms ) {
+    Attempts += 1 ;
+    Failures += OK ? 0 : 1 ;
+    Last_ms   = Duration_ms ;
+    Total_ms += Duration_ms ;
+  }
+} ;
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _Metrics_Renderer {
+
+  public:
+    void Start ( const _Metric *Metrics ) {
+      _Current  = Metrics ;
+      _Line_No  = 0 ;
+      _Line_Len = 0 ;
+      _Line_Pos = 0 ;
+    }
+
+    // ***********************************************************************
+    // Returns the number of bytes in Out, 0 if the page is complete
+    // ***********************************************************************
+    int Fill ( char *Out, int Size ) {
+      int N = 0 ;
+      while ( N < Size ) {
+        if ( _Line_Pos < _Line_Len ) {
+          int Len = min ( _Line_Len - _Line_Pos, Size - N ) ;
+          memcpy ( Out + N, _Line + _Line_Pos, Len ) ;
+          _Line_Pos += Len ;
+          N         += Len ;
+          continue ;
+        }
+        if ( ! _Next_Line () ) {
+          break ;
+        }
+      }
+      return N ;
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    const _Metric *_Current  = NULL ;
+    int            _Line_No  = 0 ;      // 0 = HELP, 1 = TYPE, 2.. = samples
+    char           _Line [ METRICS_LINE_SIZE ] ;
+    int            _Line_Len = 0 ;
+    int            _Line_Pos = 0 ;
+
+    // ***********************************************************************
+    // The next line of the current metric, or the first line of the next metric
+    // ***********************************************************************
+    bool _Next_Line () {
+      while ( ( _Current != NULL ) && ( _Current->Name != NULL ) ) {
+        int Line_No = _Line_No++ ;
+        if ( Line_No == 0 ) {
+          _Line_Len = snprintf ( _Line, sizeof ( _Line ), "# HELP %s %s\n", _Current->Name, _Current->Help ) ;
+        }
+        else if ( Line_No == 1 ) {
+          _Line_Len = snprintf ( _Line, sizeof ( _Line ), "# TYPE %s %s\n", _Current->Name, _Current->Type ) ;
+        }
+        else {
+          int Len = snprintf ( _Line, sizeof ( _Line ), "%s", _Current->Name ) ;
+          if ( ! _Current->Get ( Line_No - 2, _Line + Len, sizeof ( _Line ) - Len - 1 ) ) {
+            _Current += 1 ;
+            _Line_No  = 0 ;
+            continue ;
+          }
+          _Line_Len = strlen ( _Line ) ;
+          _Line [ _Line_Len++ ] = '\n' ;
+        }
+        _Line_Len = min ( _Line_Len, (int) sizeof ( _Line ) - 1 ) ;
+        _Line_Pos = 0 ;
+        return true ;
+      }
+      return false ;
+    }
+} ;
+
+#endif
@@ -11,6 +11,8 @@ extern "C" {
 #include "user_interface.h"      //system_get_sdk_version()
 }
 
+#include "RTC_State.h"
+
 
 // *********************************************************************************************
 // prototype
@@ -18,6 +20,31 @@ extern "C" {
 void Wifi_Connect () ;
 void Wifi_Connect ( uint8_t* My_IP_Address ) ;
 
+// *********************************************************************************************
+// time to connect, for the last connect, exported as a metric
+//   WIFI_FAST_TIMEOUT_MS : maximum time of the fast connect, with the cached BSSID and channel
+// *********************************************************************************************
+#define WIFI_FAST_TIMEOUT_MS   3000
+#define WIFI_TIMEOUT_MS        20000
+
+unsigned long Wifi_Connect_ms   = 0 ;
+bool          Wifi_Fast_Connect = false ;
+
+// *********************************************************************************************
+// Wait until connected, returns false after Timeout_ms
+// *********************************************************************************************
+bool Wifi_Wait ( unsigned long Timeout_ms ) {
+  unsigned long Start = millis () ;
+  while ( ( WiFi.status() != WL_CONNECTED ) && ( ( millis () - Start ) < Timeout_ms ) ) {
+    delay ( 10 ) ;
+  }
+  if ( Verbose > 1 ) {
+    DEBUG_SERIAL.print   ( "Wifi connect time = " ) ;
+    DEBUG_SERIAL.println ( millis () - Start ) ;
+  }
+  return WiFi.status() == WL_CONNECTED ;
+}
+
 // *********************************************************************************************
 // *********************************************************************************************
 void Wifi_Connect () {
@@ -36,65 +63,129 @@ void Wifi_Connect ( uint8_t* My_IP_Address ) {
   wifi_set_opmode ( 0x01 ) ;                  // 1= Station,  2=SoftAP,  3=Station + SoftAP
 
   //******************************************************
+  // a fixed IP address, the gateway and subnet are taken
+  //   from the last connection or else x.x.x.1 / 255.255.255.0
   //******************************************************
+  _RTC_Wifi &Cache = RTC_State.Data.Wifi ;
+  unsigned long Start = millis () ;
   if ( My_IP_Address[0] > 0 ) {
     IPAddress ip      ( My_IP_Address ) ;       // desired IP address
-    IPAddress gateway ( 192, 168, 0,   1 ) ;    // IP address of the router
+    IPAddress gateway ( My_IP_Address[0], My_IP_Address[1], My_IP_Address[2], 1 ) ;    // IP address of the router
     IPAddress subnet  ( 255, 255, 255, 0 ) ;
-    WiFi.config ( ip, gateway, subnet ) ;
+    IPAddress dns     = gateway ;
+    if ( Cache.Valid ) {
+      gateway = Cache.Gateway ;
+      subnet  = Cache.Subnet ;
+      dns     = Cache.DNS ;
+    }
+    WiFi.config ( ip, gateway, subnet, dns ) ;
+  }
+  //******************************************************
+  // DHCP: the lease is always requested, only the access point
+  //   ( BSSID and channel ) of the last connection is reused,
+  //   a cached lease would become a static IP after it expires
+  //******************************************************
+  else {
+    WiFi.config ( 0U, 0U, 0U ) ;
   }
 
   //******************************************************
+  // fast connect: no scan, directly to the last access point
+  //   if that fails, a normal connect with a full scan
   //******************************************************
-  int Connect_Count = 200 ;
-  WiFi.begin ( Wifi_User, Wifi_Pwd ) ;
-  while ( ( WiFi.status() != WL_CONNECTED ) && ( Connect_Count > 0 ) ) {
-    delay ( 100 ) ;
-    Connect_Count -= 1 ;
-    if ( Verbose > 1 ) {
-      Serial.print ( "." ) ;
+  WiFi.persistent ( false ) ;
+  Wifi_Fast_Connect = false ;
+  if ( Cache.Valid ) {
+    WiFi.begin ( Wifi_User, Wifi_Pwd, Cache.Channel, Cache.BSSID ) ;
+    Wifi_Fast_Connect = Wifi_Wait ( WIFI_FAST_TIMEOUT_MS ) ;
+    if ( ! Wifi_Fast_Connect ) {
+      WiFi.disconnect () ;
+      Cache.Valid = 0 ;
     }
   }
+  if ( ! Wifi_Fast_Connect ) {
+    WiFi.begin ( Wifi_User, Wifi_Pwd ) ;
+    Wifi_Wait ( WIFI_TIMEOUT_MS ) ;
+  }
+  Wifi_Connect_ms = millis () - Start ;
 
   //******************************************************
   //******************************************************
   if ( WiFi.status() == WL_CONNECTED ) {
     if ( Verbose > 3 ) {
-      Serial.println () ;
-      Serial.print   ( "IP          = " ) ;
-      Serial.println ( WiFi.localIP() ) ;
-      //Serial.print   ( "Subnet      = " ) ;
-      //Serial.println ( WiFi.subnetMask());
-      Serial.print   ( "Gateway     = " ) ;
-      Serial.println ( WiFi.gatewayIP() ) ;
-      Serial.print   ( "SDK version = " ) ;
-      Serial.println ( system_get_sdk_version() ) ;
+      DEBUG_SERIAL.println () ;
+      DEBUG_SERIAL.print   ( "IP          = " ) ;
+      DEBUG_SERIAL.println ( WiFi.localIP() ) ;
+      //DEBUG_SERIAL.print   ( "Subnet      = " ) ;
+      //DEBUG_SERIAL.println ( WiFi.subnetMask());
+      DEBUG_SERIAL.print   ( "Gateway     = " ) ;
+      DEBUG_SERIAL.println ( WiFi.gatewayIP() ) ;
+      DEBUG_SERIAL.print   ( "SDK version = " ) ;
+      DEBUG_SERIAL.println ( system_get_sdk_version() ) ;
+    }
+
+    // ********************************************************************
+    // remember the connection parameters in RTC memory, see RTC_State.h
+    //   so the next connect ( after a reset or deep sleep ) is fast
+    // ********************************************************************
+    Cache.Valid   = 1 ;
+    Cache.Channel = WiFi.channel () ;
+    memcpy ( Cache.BSSID, WiFi.BSSID (), sizeof ( Cache.BSSID ) ) ;
+    Cache.Gateway = WiFi.gatewayIP  () ;
+    Cache.Subnet  = WiFi.subnetMask () ;
+    Cache.DNS     = WiFi.dnsIP      () ;
+    RTC_State.Write () ;
+  }
+}
+
+
+// *********************************************************************************************
+// The primary broker and the fallback brokers form the failover list,
+//   PubSubClient keeps a health score per broker and tries the best first.
+// Called once in setup, not on every Wi-Fi connect, otherwise the scores are lost
+// *********************************************************************************************
+void MQTT_Brokers () {
+  client.setServer   ( Broker_IP, Broker_Port ) ;
+  client.clearServers () ;
+  client.addServer   ( Broker_IP, Broker_Port ) ;
+  for ( unsigned int i = 0; i < sizeof ( Broker_Fallback_IP ) / sizeof ( Broker_Fallback_IP[0] ); i++ ) {
+    if ( strlen ( Broker_Fallback_IP [i] ) > 0 ) {
+      client.addServer ( Broker_Fallback_IP [i], Broker_Fallback_Port [i] ) ;
     }
-    client.setServer ( Broker_IP, Broker_Port ) ;
   }
 }
 
 
 // *********************************************************************************************
+// MQTT_Connects counts the successful connections, so the reconnects are MQTT_Connects - 1
 // *********************************************************************************************
+unsigned long MQTT_Connects = 0 ;
+
 void MQTT_Connect () {
+  LOOP_TIME ( STAGE_MQTT_CONNECT ) ;
 
   int MQTT_Count = 25;
 
   while ( !client.connected() && ( MQTT_Count > 0 ) ) {
 
-    if ( client.connect ( MQTT_ID.c_str(), MQTT_User, MQTT_Pwd, 
-                          Subscription_Out.c_str(), 1, 1, LWT.c_str() )) {
+    // ******************************************************************
+    // tries all brokers in the failover list,
+    // if a race client is set, the two best brokers are tried in parallel
+    // ******************************************************************
+    if ( client.connectFailover ( MQTT_ID.c_str(), MQTT_User, MQTT_Pwd, 
+                                  Subscription_Out.c_str(), 1, 1, LWT.c_str() )) {
       // resubscribe, LET OP: MQTTQOS1 lijkt de zaak op te hangen
       client.subscribe ( Subscription.c_str(), MQTTQOS0 ) ;
+      MQTT_Connects += 1 ;
       // and publish ALIVE
       //client.publish ( Subscription_Out.c_str(), ALIVE.c_str() );
-      Serial.println ( "MQTT subscribed" );
+      DEBUG_SERIAL.print   ( "MQTT subscribed, broker = " );
+      DEBUG_SERIAL.println ( client.currentServer () );
     } 
     else {
       if ( Verbose > 0 ) {
-        Serial.print   ( "failed, rc = " ) ;
-        Serial.println ( client.state() ) ;
+        DEBUG_SERIAL.print   ( "failed, rc = " ) ;
+        DEBUG_SERIAL.println ( client.state() ) ;
       }
       // Wait 0.1 seconds before retrying
       delay ( 100 ) ;
@@ -107,4 +198,64 @@ void MQTT_Connect () {
 
 }
 
-
+
+// *********************************************************************************************
+// Radio duty cycling ( RADIO_DUTY_CYCLE in ext_def.h )
+//   the modem is switched off while the sensors are sampling,
+//   and only switched on for the upload windows
+// The radio on-time is measured per hour, Radio_On_Hour_ms is the last complete hour
+// *********************************************************************************************
+bool          Radio_Is_On       = true ;
+unsigned long Radio_On_Since    = 0 ;
+unsigned long Radio_On_ms       = 0 ;       // in the current hour
+unsigned long Radio_On_Hour_ms  = 0 ;       // in the last complete hour
+unsigned long Radio_Hour_Start  = 0 ;
+
+// *********************************************************************************************
+// Wake the modem and connect ( the fast connect will normally be used )
+// *********************************************************************************************
+void Radio_On ( uint8_t* My_IP_Address ) {
+  if ( ! Radio_Is_On ) {
+    WiFi.forceSleepWake () ;
+    delay ( 1 ) ;
+    Radio_Is_On    = true ;
+    Radio_On_Since = millis () ;
+  }
+  if ( WiFi.status() != WL_CONNECTED ) {
+    Wifi_Connect ( My_IP_Address ) ;
+  }
+}
+
+// *********************************************************************************************
+// Close the MQTT connection ( no LWT ) and switch the modem off
+// *********************************************************************************************
+void Radio_Off () {
+  if ( ! Radio_Is_On ) {
+    return ;
+  }
+  if ( client.connected() ) {
+    client.disconnect () ;
+  }
+  WiFi.disconnect () ;
+  WiFi.mode ( WIFI_OFF ) ;
+  WiFi.forceSleepBegin () ;
+  delay ( 1 ) ;
+  Radio_Is_On  = false ;
+  Radio_On_ms += millis () - Radio_On_Since ;
+}
+
+// *********************************************************************************************
+// Should be called regularly, for the hourly radio on-time
+// *********************************************************************************************
+void Radio_loop ( unsigned long Now ) {
+  if ( ( Now - Radio_Hour_Start ) < 3600000UL ) {
+    return ;
+  }
+  if ( Radio_Is_On ) {
+    Radio_On_ms   += Now - Radio_On_Since ;
+    Radio_On_Since = Now ;
+  }
+  Radio_On_Hour_ms  = Radio_On_ms ;
+  Radio_On_ms       = 0 ;
+  Radio_Hour_Start += 3600000UL ;
+}
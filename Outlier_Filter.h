@@ -0,0 +1,111 @@
+// ***********************************************************************************
+// This file implements a streaming outlier filter ( Hampel filter ) for the sensor samples.
+//
+// The last Window samples are kept in a small ring.
+// A new sample is rejected if it's too far from the median of the ring :
+//     | x - median | > max ( K * 1.4826 * MAD, Min_Dev + Min_Rel * median )
+//   MAD     = median of the absolute deviations from the median
+//   1.4826  = scale factor, so K * 1.4826 * MAD is K standard deviations for normal data
+//   Min_Dev = lower limit, otherwise a constant signal ( MAD = 0 ) rejects every change
+//
+// Every sample ( also a rejected one ) is added to the ring,
+//   so after a real step change, the median follows within Window / 2 samples.
+// The memory is constant, no heap is used.
+//
+// Public Functions implemented :
+//     bool Accept ( uint16_t Value ) {    // adds the sample, true if it's not an outlier
+//     void Reset () {
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Outlier_Filter_h
+#define _Outlier_Filter_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version, Hampel filter
+// ***********************************************************************************
+String _Outlier_Filter_Version      = "0.1" ;
+String _Outlier_Filter_Version_Date = "18-10-2026" ;
+String _Outlier_Filter_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+template < int Window >
+class _Outlier_Filter {
+
+  public:
+    float    K       = 3.0 ;     // threshold in standard deviations
+    uint16_t Min_Dev = 50 ;      // minimum allowed deviation, in units of the samples
+    float    Min_Rel = 0.2 ;     // minimum allowed deviation, relative to the median
+
+    // ***********************************************************************
+    // Add the sample to the ring and test it against the median of the ring.
+    // As long as the ring holds less than 3 samples, every sample is accepted.
+    // ***********************************************************************
+    bool Accept ( uint16_t Value ) {
+      _Ring [ _Pos ] = Value ;
+      _Pos = ( _Pos + 1 ) % Window ;
+      if ( _N < Window ) {
+        _N += 1 ;
+      }
+      if ( _N < 3 ) {
+        return true ;
+      }
+
+      uint16_t Sorted [ Window ] ;
+      memcpy ( Sorted, _Ring, _N * sizeof ( uint16_t ) ) ;
+      uint16_t Median = _Median ( Sorted ) ;
+
+      for ( int i = 0; i < _N; i++ ) {
+        Sorted [i] = ( _Ring [i] > Median ) ? _Ring [i] - Median : Median - _Ring [i] ;
+      }
+      uint16_t MAD = _Median ( Sorted ) ;
+
+      float Deviation = ( Value > Median ) ? Value - Median : Median - Value ;
+      float Limit     = max ( K * 1.4826f * MAD, Min_Dev + Min_Rel * Median ) ;
+      return Deviation <= Limit ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void Reset () {
+      _N   = 0 ;
+      _Pos = 0 ;
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    uint16_t _Ring [ Window ] ;
+    int      _N   = 0 ;
+    int      _Pos = 0 ;
+
+    // ***********************************************************************
+    // Insertion sort, fast enough for a few samples
+    // ***********************************************************************
+    uint16_t _Median ( uint16_t *Values ) {
+      for ( int i = 1; i < _N; i++ ) {
+        uint16_t Value = Values [i] ;
+        int      j     = i - 1 ;
+        while ( ( j >= 0 ) && ( Values [j] > Value ) ) {
+          Values [ j + 1 ] = Values [j] ;
+          j -= 1 ;
+        }
+        Values [ j + 1 ] = Value ;
+      }
+      return Values [ _N / 2 ] ;
+    }
+} ;
+
+#endif
@@ -124,53 +124,7 @@ boolean PubSubClient::connect(const char *id, const char *user, const char *pass
         }
         if (result == 1) {
             nextMsgId = 1;
-            // Leave room in the buffer for header and variable length field
-            uint16_t length = 5;
-            unsigned int j;
-
-#if MQTT_VERSION == MQTT_VERSION_3_1
-            uint8_t d[9] = {0x00,0x06,'M','Q','I','s','d','p', MQTT_VERSION};
-#define MQTT_HEADER_VERSION_LENGTH 9
-#elif MQTT_VERSION == MQTT_VERSION_3_1_1
-            uint8_t d[7] = {0x00,0x04,'M','Q','T','T',MQTT_VERSION};
-#define MQTT_HEADER_VERSION_LENGTH 7
-#endif
-            for (j = 0;j<MQTT_HEADER_VERSION_LENGTH;j++) {
-                buffer[length++] = d[j];
-            }
-
-            uint8_t v;
-            if (willTopic) {
-                v = 0x06|(willQos<<3)|(willRetain<<5);
-            } else {
-                v = 0x02;
-            }
-
-            if(user != NULL) {
-                v = v|0x80;
-
-                if(pass != NULL) {
-                    v = v|(0x80>>1);
-                }
-            }
-
-            buffer[length++] = v;
-
-            buffer[length++] = ((MQTT_KEEPALIVE) >> 8);
-            buffer[length++] = ((MQTT_KEEPALIVE) & 0xFF);
-            length = writeString(id,buffer,length);
-            if (willTopic) {
-                length = writeString(willTopic,buffer,length);
-                length = writeString(willMessage,buffer,length);
-            }
-
-            if(user != NULL) {
-                length = writeString(user,buffer,length);
-                if(pass != NULL) {
-                    length = writeString(pass,buffer,length);
-                }
-            }
-
+            uint16_t length = buildConnect(id,user,pass,willTopic,willQos,willRetain,willMessage);
             write(MQTTCONNECT,buffer,length-5);
 
             lastInActivity = lastOutActivity = millis();
@@ -205,6 +159,194 @@ boolean PubSubClient::connect(const char *id, const char *user, const char *pass
     return true;
 }
 
+// builds the CONNECT packet in buffer, returns the length including the 5 header bytes
+uint16_t PubSubClient::buildConnect(const char *id, const char *user, const char *pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage) {
+    // Leave room in the buffer for header and variable length field
+    uint16_t length = 5;
+    unsigned int j;
+
+#if MQTT_VERSION == MQTT_VERSION_3_1
+    uint8_t d[9] = {0x00,0x06,'M','Q','I','s','d','p', MQTT_VERSION};
+#define MQTT_HEADER_VERSION_LENGTH 9
+#elif MQTT_VERSION == MQTT_VERSION_3_1_1
+    uint8_t d[7] = {0x00,0x04,'M','Q','T','T',MQTT_VERSION};
+#define MQTT_HEADER_VERSION_LENGTH 7
+#endif
+    for (j = 0;j<MQTT_HEADER_VERSION_LENGTH;j++) {
+        buffer[length++] = d[j];
+    }
+
+    uint8_t v;
+    if (willTopic) {
+        v = 0x06|(willQos<<3)|(willRetain<<5);
+    } else {
+        v = 0x02;
+    }
+
+    if(user != NULL) {
+        v = v|0x80;
+
+        if(pass != NULL) {
+            v = v|(0x80>>1);
+        }
+    }
+
+    buffer[length++] = v;
+
+    buffer[length++] = ((MQTT_KEEPALIVE) >> 8);
+    buffer[length++] = ((MQTT_KEEPALIVE) & 0xFF);
+    length = writeString(id,buffer,length);
+    if (willTopic) {
+        length = writeString(willTopic,buffer,length);
+        length = writeString(willMessage,buffer,length);
+    }
+
+    if(user != NULL) {
+        length = writeString(user,buffer,length);
+        if(pass != NULL) {
+            length = writeString(pass,buffer,length);
+        }
+    }
+    return length;
+}
+
+boolean PubSubClient::connectFailover(const char *id, const char *user, const char *pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage) {
+    if (brokerCount == 0) {
+        return connect(id,user,pass,willTopic,willQos,willRetain,willMessage);
+    }
+    if (connected()) {
+        return true;
+    }
+
+    // Order the brokers on their score, equal scores keep the order of the list
+    uint8_t order[MQTT_MAX_BROKERS];
+    uint8_t i, j;
+    for (i = 0;i<brokerCount;i++) {
+        uint8_t index = i;
+        for (j = i;(j > 0) && (brokers[order[j-1]].score < brokers[index].score);j--) {
+            order[j] = order[j-1];
+        }
+        order[j] = index;
+    }
+
+    // Try the candidates in pairs when a race client is available,
+    // the first CONNACK that arrives wins, the other connection is dropped
+    i = 0;
+    while (i < brokerCount) {
+        uint8_t first = order[i++];
+        uint8_t second = 0;
+        boolean race = (_raceClient != NULL) && (i < brokerCount);
+        if (race) {
+            second = order[i++];
+        }
+
+        Client* primary = _client;
+        boolean firstOpen = openBroker(primary, first);
+        boolean secondOpen = race && openBroker(_raceClient, second);
+        if (!firstOpen) {
+            scoreBroker(first, -2);
+        }
+        if (race && !secondOpen) {
+            scoreBroker(second, -2);
+        }
+        if (!firstOpen && !secondOpen) {
+            _state = MQTT_CONNECT_FAILED;
+            continue;
+        }
+
+        nextMsgId = 1;
+        uint16_t length = buildConnect(id,user,pass,willTopic,willQos,willRetain,willMessage);
+        if (firstOpen) {
+            write(MQTTCONNECT,buffer,length-5);
+        }
+        if (secondOpen) {
+            // write() only prepends the fixed header, so the packet can be sent twice
+            _client = _raceClient;
+            write(MQTTCONNECT,buffer,length-5);
+        }
+        lastInActivity = lastOutActivity = millis();
+
+        Client* winner = raceConnack(firstOpen ? primary : NULL, first, secondOpen ? _raceClient : NULL, second);
+        if (winner != NULL) {
+            if (winner != primary) {
+                _raceClient = primary;
+            }
+            _client = winner;
+            this->domain = brokers[currentBroker].domain;
+            this->ip = brokers[currentBroker].ip;
+            this->port = brokers[currentBroker].port;
+            lastInActivity = millis();
+            pingOutstanding = false;
+            return true;
+        }
+        _client = primary;
+    }
+    currentBroker = -1;
+    return false;
+}
+
+boolean PubSubClient::openBroker(Client* client, uint8_t index) {
+    if (brokers[index].domain != NULL) {
+        return client->connect(brokers[index].domain, brokers[index].port) == 1;
+    }
+    return client->connect(brokers[index].ip, brokers[index].port) == 1;
+}
+
+// waits for the CONNACK of one or two pending connections (NULL if not pending),
+// returns the client of the first accepted connection or NULL
+Client* PubSubClient::raceConnack(Client* first, uint8_t firstIndex, Client* second, uint8_t secondIndex) {
+    Client* candidate[2] = {first, second};
+    uint8_t index[2] = {firstIndex, secondIndex};
+    uint8_t c;
+
+    _state = MQTT_CONNECTION_TIMEOUT;
+    while ((candidate[0] != NULL) || (candidate[1] != NULL)) {
+        if (millis()-lastInActivity >= ((int32_t) MQTT_SOCKET_TIMEOUT*1000UL)) {
+            _state = MQTT_CONNECTION_TIMEOUT;
+            break;
+        }
+        for (c = 0;c<2;c++) {
+            if ((candidate[c] == NULL) || !candidate[c]->available()) {
+                continue;
+            }
+            _client = candidate[c];
+            candidate[c] = NULL;
+            uint8_t llen;
+            uint16_t len = readPacket(&llen);
+            if ((len == 4) && (buffer[3] == 0)) {
+                if (candidate[1-c] != NULL) {
+                    candidate[1-c]->stop();
+                }
+                scoreBroker(index[c], 1);
+                currentBroker = index[c];
+                _state = MQTT_CONNECTED;
+                return _client;
+            }
+            _state = (len == 4) ? buffer[3] : MQTT_CONNECT_FAILED;
+            _client->stop();
+            scoreBroker(index[c], -2);
+        }
+        yield();
+    }
+    for (c = 0;c<2;c++) {
+        if (candidate[c] != NULL) {
+            candidate[c]->stop();
+            scoreBroker(index[c], -2);
+        }
+    }
+    return NULL;
+}
+
+void PubSubClient::scoreBroker(uint8_t index, int8_t delta) {
+    int16_t score = brokers[index].score + delta;
+    if (score > MQTT_BROKER_SCORE_MAX) {
+        score = MQTT_BROKER_SCORE_MAX;
+    } else if (score < -MQTT_BROKER_SCORE_MAX) {
+        score = -MQTT_BROKER_SCORE_MAX;
+    }
+    brokers[index].score = score;
+}
+
 // reads a byte into result
 boolean PubSubClient::readByte(uint8_t * result) {
    uint32_t previousMillis = millis();
@@ -552,6 +694,14 @@ boolean PubSubClient::connected() {
     return rc;
 }
 
+// Bytes received on the active connection, the race client after a race win
+int PubSubClient::available() {
+    if (_client == NULL) {
+        return 0;
+    }
+    return _client->available();
+}
+
 PubSubClient& PubSubClient::setServer(uint8_t * ip, uint16_t port) {
     IPAddress addr(ip[0],ip[1],ip[2],ip[3]);
     return setServer(addr,port);
@@ -570,6 +720,43 @@ PubSubClient& PubSubClient::setServer(const char * domain, uint16_t port) {
     return *this;
 }
 
+PubSubClient& PubSubClient::addServer(uint8_t * ip, uint16_t port) {
+    IPAddress addr(ip[0],ip[1],ip[2],ip[3]);
+    return addServer(addr,port);
+}
+
+PubSubClient& PubSubClient::addServer(IPAddress ip, uint16_t port) {
+    if (brokerCount < MQTT_MAX_BROKERS) {
+        brokers[brokerCount].domain = NULL;
+        brokers[brokerCount].ip = ip;
+        brokers[brokerCount].port = port;
+        brokers[brokerCount].score = 0;
+        brokerCount++;
+    }
+    return *this;
+}
+
+PubSubClient& PubSubClient::addServer(const char * domain, uint16_t port) {
+    if (brokerCount < MQTT_MAX_BROKERS) {
+        brokers[brokerCount].domain = domain;
+        brokers[brokerCount].port = port;
+        brokers[brokerCount].score = 0;
+        brokerCount++;
+    }
+    return *this;
+}
+
+PubSubClient& PubSubClient::clearServers() {
+    this->brokerCount = 0;
+    this->currentBroker = -1;
+    return *this;
+}
+
+PubSubClient& PubSubClient::setRaceClient(Client& client){
+    this->_raceClient = &client;
+    return *this;
+}
+
 PubSubClient& PubSubClient::setCallback(MQTT_CALLBACK_SIGNATURE) {
     this->callback = callback;
     return *this;
@@ -587,4 +774,15 @@ PubSubClient& PubSubClient::setStream(Stream& stream){
 
 int PubSubClient::state() {
     return this->_state;
-}
+}
+
+int8_t PubSubClient::currentServer() {
+    return this->currentBroker;
+}
+
+int8_t PubSubClient::serverScore(uint8_t index) {
+    if (index >= brokerCount) {
+        return 0;
+    }
+    return brokers[index].score;
+}
@@ -46,6 +46,16 @@
 #define MQTT_SOCKET_TIMEOUT 15
 #endif
 
+// MQTT_MAX_BROKERS : Maximum number of brokers in the failover list
+#ifndef MQTT_MAX_BROKERS
+#define MQTT_MAX_BROKERS 4
+#endif
+
+// MQTT_BROKER_SCORE_MAX : health score limits of a broker in the failover list
+#ifndef MQTT_BROKER_SCORE_MAX
+#define MQTT_BROKER_SCORE_MAX 10
+#endif
+
 // MQTT_MAX_TRANSFER_SIZE : limit how much data is passed to the network client
 //  in each write call. Needed for the Arduino Wifi Shield. Leave undefined to
 //  pass the entire MQTT packet in each write call.
@@ -90,6 +100,16 @@
 #define MQTT_CALLBACK_SIGNATURE void (*callback)(char*, uint8_t*, unsigned int)
 #endif
 
+// One entry of the failover broker list.
+// score goes up on every successful connect and down on every failure,
+// connectFailover() tries the brokers with the highest score first.
+typedef struct {
+   const char* domain;
+   IPAddress ip;
+   uint16_t port;
+   int8_t score;
+} MQTTBroker;
+
 class PubSubClient {
 private:
    Client* _client;
@@ -104,11 +124,19 @@ private:
    boolean readByte(uint8_t * result, uint16_t * index);
    boolean write(uint8_t header, uint8_t* buf, uint16_t length);
    uint16_t writeString(const char* string, uint8_t* buf, uint16_t pos);
+   uint16_t buildConnect(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage);
+   boolean openBroker(Client* client, uint8_t index);
+   Client* raceConnack(Client* first, uint8_t firstIndex, Client* second, uint8_t secondIndex);
+   void scoreBroker(uint8_t index, int8_t delta);
    IPAddress ip;
    const char* domain;
    uint16_t port;
    Stream* stream;
    int _state;
+   Client* _raceClient = NULL;
+   MQTTBroker brokers[MQTT_MAX_BROKERS];
+   uint8_t brokerCount = 0;
+   int8_t currentBroker = -1;
 public:
    PubSubClient();
    PubSubClient(Client& client);
@@ -132,10 +160,17 @@ public:
    PubSubClient& setClient(Client& client);
    PubSubClient& setStream(Stream& stream);
 
+   PubSubClient& addServer(IPAddress ip, uint16_t port);
+   PubSubClient& addServer(uint8_t * ip, uint16_t port);
+   PubSubClient& addServer(const char * domain, uint16_t port);
+   PubSubClient& clearServers();
+   PubSubClient& setRaceClient(Client& client);
+
    boolean connect(const char* id);
    boolean connect(const char* id, const char* user, const char* pass);
    boolean connect(const char* id, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage);
    boolean connect(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage);
+   boolean connectFailover(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage);
    void disconnect();
    boolean publish(const char* topic, const char* payload);
    boolean publish(const char* topic, const char* payload, boolean retained);
@@ -147,8 +182,11 @@ public:
    boolean unsubscribe(const char* topic);
    boolean loop();
    boolean connected();
+   int available();
    int state();
+   int8_t currentServer();
+   int8_t serverScore(uint8_t index);
 };
 
 
-#endif
+#endif
@@ -0,0 +1,174 @@
+// ***********************************************************************************
+// This file implements the state that's kept in the RTC memory of the ESP8266.
+//
+// The RTC memory survives a deep sleep and a reset ( not a power cycle ),
+//   so after a wake-up from deep sleep the node can continue where it stopped :
+//     - scheduler state      : boot count, total awake and sleep time
+//     - sensor state         : adaptive pause time, laser on-time, last working period
+//     - upload state         : sequence number of the last message and failed uploads
+//     - Wi-Fi parameters     : BSSID and channel of the last connection,
+//                              gateway, subnet and DNS for a fixed IP address
+// The data is protected by a CRC32, after a power cycle the CRC is wrong
+//   and all data is cleared.
+//
+// The first 128 bytes of the user RTC memory are used by the OTA update,
+//   so the state starts at RTC_STATE_OFFSET ( in 4-byte blocks ).
+//
+// Public Functions implemented :
+//     bool Read () {          // true if the RTC memory holds a valid state
+//     void Write () {
+//     void Clear () {
+//     void Add_Cycle ( unsigned long Awake_ms, unsigned long Sleep_ms ) {
+//     float Duty_Cycle () {   // awake part of the total time, 0 .. 1
+//     float Mean_Current_mA ( float Awake_mA, float Sleep_mA ) {
+//     _RTC_Data Data          // the state itself
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _RTC_State_h
+#define _RTC_State_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version
+// ***********************************************************************************
+String _RTC_State_Version      = "0.1" ;
+String _RTC_State_Version_Date = "18-10-2026" ;
+String _RTC_State_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+
+#define RTC_STATE_OFFSET    32              // 128 bytes, used by OTA
+#define RTC_STATE_MAGIC     0x46535432      // "FST2", change if _RTC_Data changes
+
+
+// ***********************************************************************************
+// Wi-Fi parameters of the last successful connection
+//   no IP address, a DHCP lease is requested at every connect
+// ***********************************************************************************
+struct _RTC_Wifi {
+  uint8_t  Valid ;
+  uint8_t  Channel ;
+  uint8_t  BSSID [6] ;
+  uint32_t Gateway ;
+  uint32_t Subnet ;
+  uint32_t DNS ;
+} ;
+
+// ***********************************************************************************
+// State of the ( first ) SDS011, see _Sensor_SDS011::Save_State
+// ***********************************************************************************
+struct _RTC_SDS011 {
+  int32_t  Pause_Time_ms ;
+  uint32_t Laser_On_s ;
+  uint32_t Laser_On_Rest_ms ;
+  uint32_t Rejected_Total ;
+  uint32_t Burst_Count ;
+  int32_t  Last_N ;
+  float    Last_Mean ;
+  float    Last_SD ;
+  float    Last_B1 ;
+  float    Previous_Mean ;
+} ;
+
+// ***********************************************************************************
+// The complete state, the size must be a multiple of 4 bytes
+// ***********************************************************************************
+struct _RTC_Data {
+  uint32_t    CRC ;
+  uint32_t    Magic ;
+  uint32_t    Boot_Count ;
+  uint32_t    Awake_ms_Total ;
+  uint32_t    Sleep_ms_Total ;
+  uint32_t    Send_Sequence ;
+  uint32_t    Send_Failed ;
+  _RTC_Wifi   Wifi ;
+  _RTC_SDS011 SDS ;
+} ;
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _RTC_State {
+
+  public:
+    _RTC_Data Data ;
+
+    // ***********************************************************************
+    // Returns false ( and clears the state ) if the RTC memory
+    //   doesn't hold a valid state, e.g. after a power cycle
+    // ***********************************************************************
+    bool Read () {
+      if ( ESP.rtcUserMemoryRead ( RTC_STATE_OFFSET, (uint32_t*) &Data, sizeof ( Data ) ) &&
+           ( Data.Magic == RTC_STATE_MAGIC ) && ( Data.CRC == _CRC () ) ) {
+        return true ;
+      }
+      Clear () ;
+      return false ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void Write () {
+      Data.Magic = RTC_STATE_MAGIC ;
+      Data.CRC   = _CRC () ;
+      ESP.rtcUserMemoryWrite ( RTC_STATE_OFFSET, (uint32_t*) &Data, sizeof ( Data ) ) ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void Clear () {
+      memset ( &Data, 0, sizeof ( Data ) ) ;
+      Data.Magic = RTC_STATE_MAGIC ;
+    }
+
+    // ***********************************************************************
+    // Energy budget, one awake period followed by a deep sleep
+    // ***********************************************************************
+    void Add_Cycle ( unsigned long Awake_ms, unsigned long Sleep_ms ) {
+      Data.Awake_ms_Total += Awake_ms ;
+      Data.Sleep_ms_Total += Sleep_ms ;
+    }
+
+    float Duty_Cycle () {
+      float Total_ms = (float) Data.Awake_ms_Total + Data.Sleep_ms_Total ;
+      return ( Total_ms > 0 ) ? Data.Awake_ms_Total / Total_ms : 0 ;
+    }
+
+    float Mean_Current_mA ( float Awake_mA, float Sleep_mA ) {
+      float Duty = Duty_Cycle () ;
+      return Duty * Awake_mA + ( 1 - Duty ) * Sleep_mA ;
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    // ***********************************************************************
+    // CRC32 over everything after the CRC itself
+    // ***********************************************************************
+    uint32_t _CRC () {
+      const uint8_t *Byte = (const uint8_t*) &Data + sizeof ( Data.CRC ) ;
+      uint32_t       CRC  = 0xFFFFFFFF ;
+      for ( unsigned int i = 0; i < sizeof ( Data ) - sizeof ( Data.CRC ); i++ ) {
+        CRC ^= Byte [i] ;
+        for ( int Bit = 0; Bit < 8; Bit++ ) {
+          CRC = ( CRC >> 1 ) ^ ( ( CRC & 1 ) ? 0xEDB88320 : 0 ) ;
+        }
+      }
+      return ~CRC ;
+    }
+} ;
+
+static_assert ( sizeof ( _RTC_Data ) % 4 == 0,   "RTC state must be a multiple of 4 bytes" ) ;
+static_assert ( sizeof ( _RTC_Data ) <= 512 - 4 * RTC_STATE_OFFSET, "RTC state too large" ) ;
+
+_RTC_State RTC_State ;
+
+#endif
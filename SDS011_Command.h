@@ -0,0 +1,116 @@
+// ***********************************************************************************
+// This file implements a compile-time builder for all SDS011 commands.
+//
+// Every command is 19 bytes :
+//   AA B4 Cmd d1 d2 d3 .. d12 ID1 ID2 CS AB
+//   CS = sum of the bytes Cmd .. ID2 ( byte 2 .. 16 ), modulo 256
+//   ID = FFFF addresses all sensors
+//
+// The builders are constexpr, so with constant arguments the complete command,
+//   including the checksum, is calculated by the compiler.
+// The fixed commands are stored in flash ( PROGMEM ).
+// The same builders can also be used at runtime, e.g. for a configurable period.
+//
+// At the bottom, the builders are checked ( static_assert ) against the
+//   examples in "Laser Dust Sensor Control Protocol_V1.4.pdf",
+//   with runtime ID's and periods in test/Test_SDS011_Command.cpp
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _SDS011_Command_h
+#define _SDS011_Command_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version
+// ***********************************************************************************
+String _SDS011_Command_Version      = "0.1" ;
+String _SDS011_Command_Version_Date = "18-10-2026" ;
+String _SDS011_Command_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+
+#define SDS011_COMMAND_LEN    19
+#define SDS011_ALL_DEVICES    0xFFFF
+
+// ***********************************************************************************
+// ***********************************************************************************
+struct _SDS011_Command {
+  uint8_t Bytes [ SDS011_COMMAND_LEN ] ;
+} ;
+
+
+// ***********************************************************************************
+// Generic builder, d1, d2 and d12/d13 ( only used to set a new Device-ID )
+// ***********************************************************************************
+constexpr _SDS011_Command _SDS011_Build ( uint8_t Cmd, uint8_t Data_1, uint8_t Data_2, uint16_t New_ID, uint16_t ID ) {
+  return { { 0xAA, 0xB4, Cmd, Data_1, Data_2,
+             0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+             uint8_t ( New_ID >> 8 ), uint8_t ( New_ID & 0xFF ),
+             uint8_t ( ID >> 8 ),     uint8_t ( ID & 0xFF ),
+             uint8_t ( Cmd + Data_1 + Data_2 + ( New_ID >> 8 ) + ( New_ID & 0xFF ) + ( ID >> 8 ) + ( ID & 0xFF ) ),
+             0xAB } } ;
+}
+
+// ***********************************************************************************
+// All commands of the protocol
+// ***********************************************************************************
+constexpr _SDS011_Command SDS011_Set_Reporting_Mode ( bool Query, uint16_t ID = SDS011_ALL_DEVICES ) {
+  return _SDS011_Build ( 0x02, 0x01, Query ? 0x01 : 0x00, 0x0000, ID ) ;
+}
+constexpr _SDS011_Command SDS011_Get_Reporting_Mode ( uint16_t ID = SDS011_ALL_DEVICES ) {
+  return _SDS011_Build ( 0x02, 0x00, 0x00, 0x0000, ID ) ;
+}
+constexpr _SDS011_Command SDS011_Query_Data ( uint16_t ID = SDS011_ALL_DEVICES ) {
+  return _SDS011_Build ( 0x04, 0x00, 0x00, 0x0000, ID ) ;
+}
+constexpr _SDS011_Command SDS011_Set_Device_ID ( uint16_t New_ID, uint16_t ID = SDS011_ALL_DEVICES ) {
+  return _SDS011_Build ( 0x05, 0x00, 0x00, New_ID, ID ) ;
+}
+constexpr _SDS011_Command SDS011_Set_Work ( bool Work, uint16_t ID = SDS011_ALL_DEVICES ) {
+  return _SDS011_Build ( 0x06, 0x01, Work ? 0x01 : 0x00, 0x0000, ID ) ;
+}
+constexpr _SDS011_Command SDS011_Get_Work ( uint16_t ID = SDS011_ALL_DEVICES ) {
+  return _SDS011_Build ( 0x06, 0x00, 0x00, 0x0000, ID ) ;
+}
+constexpr _SDS011_Command SDS011_Get_Firmware ( uint16_t ID = SDS011_ALL_DEVICES ) {
+  return _SDS011_Build ( 0x07, 0x00, 0x00, 0x0000, ID ) ;
+}
+// Minutes = 0 is continuous mode, 1 .. 30 minutes
+constexpr _SDS011_Command SDS011_Set_Working_Period ( uint8_t Minutes, uint16_t ID = SDS011_ALL_DEVICES ) {
+  return _SDS011_Build ( 0x08, 0x01, Minutes, 0x0000, ID ) ;
+}
+constexpr _SDS011_Command SDS011_Get_Working_Period ( uint16_t ID = SDS011_ALL_DEVICES ) {
+  return _SDS011_Build ( 0x08, 0x00, 0x00, 0x0000, ID ) ;
+}
+
+
+// ***********************************************************************************
+// The fixed commands, calculated by the compiler and stored in flash
+// ***********************************************************************************
+const _SDS011_Command SDS011_CMD_WORK       PROGMEM = SDS011_Set_Work     ( true  ) ;
+const _SDS011_Command SDS011_CMD_SLEEP      PROGMEM = SDS011_Set_Work     ( false ) ;
+const _SDS011_Command SDS011_CMD_QUERY      PROGMEM = SDS011_Query_Data   () ;
+const _SDS011_Command SDS011_CMD_FIRMWARE   PROGMEM = SDS011_Get_Firmware () ;
+
+
+// ***********************************************************************************
+// Check the builders against the examples in the protocol description
+// ***********************************************************************************
+static_assert ( SDS011_Set_Work ( true  ).Bytes [17] == 0x06, "SDS011 work command"  ) ;
+static_assert ( SDS011_Set_Work ( false ).Bytes [17] == 0x05, "SDS011 sleep command" ) ;
+static_assert ( SDS011_Get_Firmware ().Bytes [17]    == 0x05, "SDS011 firmware command" ) ;
+static_assert ( SDS011_Query_Data ().Bytes [17]      == 0x02, "SDS011 query command" ) ;
+static_assert ( SDS011_Set_Reporting_Mode ( true ).Bytes [17] == 0x02, "SDS011 query mode command" ) ;
+static_assert ( SDS011_Set_Working_Period ( 1 ).Bytes [17]    == 0x08, "SDS011 working period command" ) ;
+static_assert ( SDS011_Set_Device_ID ( 0xA001, 0xA160 ).Bytes [17] == 0xA7, "SDS011 set Device-ID command" ) ;
+static_assert ( SDS011_Set_Device_ID ( 0xA001, 0xA160 ).Bytes [13] == 0xA0, "SDS011 set Device-ID command" ) ;
+static_assert ( SDS011_Set_Device_ID ( 0xA001, 0xA160 ).Bytes [16] == 0x60, "SDS011 set Device-ID command" ) ;
+
+#endif
@@ -0,0 +1,135 @@
+// ***********************************************************************************
+// This file implements a compile-time list of all sensors on the node.
+//
+// The sensors are selected by the *_READ flags in ext_def.h.
+// All calls are resolved at compile time ( no virtual functions, no heap ),
+//   a sensor that's not selected is not instantiated at all,
+//   so it costs no flash and no RAM.
+//
+// Every sensor class should have :
+//     a default constructor ( pins are taken from ext_def.h )
+//     void   loop ()
+//     String Get_JSON_Data ()
+//     unsigned long Next_Event_ms ( unsigned long Now )   // time until loop has something to do
+//                                                         // at most IDLE_MAX_MS, see Remaining_ms
+//
+// Public Functions implemented :
+//     void   loop () {                    // calls loop of all sensors
+//     String Get_JSON_Data () {           // concatenated JSON of all sensors
+//     unsigned long Next_Event_ms ( unsigned long Now ) {   // earliest event of all sensors
+//     S&     Get <S> () {                 // direct access to the sensor of type S
+//     int    N_Sensors                    // number of selected sensors
+//     unsigned long Remaining_ms ( unsigned long Now, unsigned long Since, unsigned long Period ) {
+//
+// Adding a new sensor type :
+//     add   _Sensor_If < XXX_READ, _Sensor_XXX >::type   to the _Sensors list in FijnStofSensor.ino
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Sensor_Registry_h
+#define _Sensor_Registry_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version, only SDS011 available
+//    - Next_Event_ms, for the idle time of the main loop
+//    - Remaining_ms, shared by the sensors and the main loop
+// ***********************************************************************************
+String _Sensor_Registry_Version      = "0.1" ;
+String _Sensor_Registry_Version_Date = "18-10-2026" ;
+String _Sensor_Registry_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+
+
+// ***********************************************************************************
+// Time until ( Now - Since ) > Period, for Next_Event_ms and the main loop
+// ***********************************************************************************
+unsigned long Remaining_ms ( unsigned long Now, unsigned long Since, unsigned long Period ) {
+  unsigned long Elapsed = Now - Since ;
+  return ( Elapsed > Period ) ? 0 : Period - Elapsed + 1 ;
+}
+
+
+// ***********************************************************************************
+// Placeholder for a sensor that's not selected, it's skipped by the registry
+// ***********************************************************************************
+class _Sensor_None {} ;
+
+template < bool Enabled, typename Sensor > struct _Sensor_If                  { typedef Sensor       type ; } ;
+template <               typename Sensor > struct _Sensor_If < false, Sensor > { typedef _Sensor_None type ; } ;
+
+
+// ***********************************************************************************
+// The registry is a recursive template,
+//   each level holds one sensor and derives from the rest of the list.
+// ***********************************************************************************
+template < typename... Sensors > class _Sensor_Registry ;
+
+// *****************************
+// end of the list, does nothing
+// *****************************
+template <> class _Sensor_Registry <> {
+  public:
+    static const int N_Sensors = 0 ;
+    void   loop          () {}
+    String Get_JSON_Data () { return "" ; }
+    unsigned long Next_Event_ms ( unsigned long ) { return 0xFFFFFFFF ; }
+  protected:
+    void   _Get          () ;
+} ;
+
+// *****************************************
+// a sensor that's not selected is skipped
+// *****************************************
+template < typename... Rest >
+class _Sensor_Registry < _Sensor_None, Rest... > : public _Sensor_Registry < Rest... > {
+} ;
+
+// *****************************************
+// a selected sensor
+// *****************************************
+template < typename First, typename... Rest >
+class _Sensor_Registry < First, Rest... > : public _Sensor_Registry < Rest... > {
+  typedef _Sensor_Registry < Rest... > _Base ;
+
+  public:
+    static const int N_Sensors = 1 + _Base::N_Sensors ;
+
+    void loop () {
+      _Sensor.loop () ;
+      _Base::loop () ;
+    }
+
+    String Get_JSON_Data () {
+      return _Sensor.Get_JSON_Data () + _Base::Get_JSON_Data () ;
+    }
+
+    unsigned long Next_Event_ms ( unsigned long Now ) {
+      unsigned long Next = _Sensor.Next_Event_ms ( Now ) ;
+      return min ( Next, _Base::Next_Event_ms ( Now ) ) ;
+    }
+
+    // ****************************************************
+    // The sensor is found by overload resolution on a tag
+    //   e.g. Sensors.Get < _Sensor_SDS011 > ().Get_Version ()
+    // ****************************************************
+    template < typename S > S& Get () {
+      return this -> _Get ( (S*) 0 ) ;
+    }
+
+  protected:
+    using  _Base::_Get ;
+    First& _Get ( First* ) { return _Sensor ; }
+
+  private:
+    First _Sensor ;
+} ;
+
+#endif
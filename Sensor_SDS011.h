@@ -8,9 +8,21 @@
 //
 // Public Functions implemented :
 //     _Sensor_SDS011 ( int RX, int TX ) {  // Constructor
+//     _Sensor_SDS011 () {                  // Constructor, pins from ext_def.h
+//     _Sensor_SDS011 ( Stream &Port ) {    // Constructor, already opened port
 //     String Get_Data () {                 // Get Data as JSON string
-//     String Get_Version () {              
+//     void   Request_Version () {          // asynchronous, result in Device_Firmware and Device_ID
+//     String Get_Version () {              // readable string of Device_Firmware and Device_ID
 //     void Set_Parameters ( int Working_Time_msec, int Pause_Time_msec, int Sample_Time_msec, int Start_Sample_N ) {
+//     void Set_Mode ( int Mode, int Period_Minutes ) {
+//     void Set_Phase ( unsigned long Offset_ms ) {
+//     String Get_JSON_Prefix () {
+//     bool Sleeping () {                   // true if the sensor is in its pause
+//     unsigned long Pause_Remaining_ms ( unsigned long Now ) {
+//     void Save_State    ( _RTC_SDS011 &State ) {
+//     void Restore_State ( const _RTC_SDS011 &State ) {
+//     unsigned long Next_Event_ms ( unsigned long Now ) {   // time until loop has something to do
+//     const _Frame_Parser < _Frame_SDS011 > &Parser () {     // frame counters
 //
 // WARNING: we assume that only experts will change the parameters, 
 //          therefor there's no check if the changed times are valid.
@@ -28,6 +40,27 @@
 
 // ***********************************************************************************
 // ***********************************************************************************
+// Version 0.3, 18-10-2026, SM
+//    - default constructor, for use in the sensor registry
+//    - frames are decoded by the table driven frame parser
+//    - query mode and working period mode ( Set_Mode )
+//    - asynchronous command transactions, with reply check, timeout and retries
+//    - commands are built at compile time by SDS011_Command.h
+//    - serial port can be SoftwareSerial, hardware UART or any Stream
+//    - running statistics instead of sample arrays ( 4 kB less per sensor )
+//    - more sensors on one node ( _Sensor_SDS011_N ), staggered working periods,
+//      the other sensors follow the ( adaptive ) schedule of the first one
+//    - adaptive duty cycle and cumulative laser on-time
+//    - automatic warm-up detection and early end of the working period
+//    - burst mode, every sample is reported during a pollution spike
+//    - outlier rejection ( Hampel filter ) and duplicate frame detection
+//    - samples are added to the on-device history, if set ( History.h )
+//    - state can be kept in RTC memory during deep sleep ( Save_State / Restore_State )
+//    - Next_Event_ms, so the main loop can idle until the next deadline
+//    - callbacks for every accepted sample and every working period, e.g. for a live view
+//    - counters of the frames ( Parser ), duplicate frames and samples per working period
+//    - the end of a working period is timed, if set ( Loop_Timing.h )
+//
 // Version 0.2, 23-04-2018, SM
 //    - added statistics: SD and average sloop
 //    - added CSV output through serial port
@@ -37,8 +70,8 @@
 //    - initial version
 //    - debug_out is used as in the orginal software
 // ***********************************************************************************
-String _Sensor_SDS011_Version      = "0.2" ;
-String _Sensor_SDS011_Version_Date = "23-04-2018" ;
+String _Sensor_SDS011_Version      = "0.3" ;
+String _Sensor_SDS011_Version_Date = "18-10-2026" ;
 String _Sensor_SDS011_Version_By   = "SM" ;
 // ***********************************************************************************
 
@@ -46,9 +79,106 @@ String _Sensor_SDS011_Version_By   = "SM" ;
 // specific imports for this module
 // ********************************
 #include <Arduino.h>
-#include <SoftwareSerial.h>
+#include "Serial_Transport.h"
 
 #include "LuftDaten.h"
+#include "Frame_Parser.h"
+#include "SDS011_Command.h"
+#include "Outlier_Filter.h"
+#include "History.h"
+#include "Loop_Timing.h"
+#include "RTC_State.h"
+#include "Sensor_Registry.h"
+
+// ***********************************************************************************
+// Driver modes, see Set_Mode
+// ***********************************************************************************
+#define SDS011_MODE_ACTIVE    0
+#define SDS011_MODE_QUERY     1
+#define SDS011_MODE_PERIOD    2
+
+// ***********************************************************************************
+// Outlier rejection, see Outlier_Filter.h
+//   a data frame equal to the previous one, received within SDS011_DUPLICATE_MS,
+//   is a duplicate ( the sensor sends at most 1 frame per second )
+// ***********************************************************************************
+#define SDS011_FILTER_WINDOW  5
+#define SDS011_DUPLICATE_MS   500
+
+// number of samples used for the warm-up detection
+#define SDS011_WARMUP_K       5
+
+// ***********************************************************************************
+// Running statistics of one channel, so no sample arrays are needed.
+// Mean, variance and the regression against the sample number are updated
+//   for every sample ( Welford's method, numerically stable ).
+//   B1 = SUM ( ( x[i] - MEAN(x) ) * ( y[i] - MEAN(y) ) ) / SUM ( ( x[i] - MEAN(x) ) ^ 2 )
+//   SD = SQRT ( SUM ( ( y[i] - MEAN(Y) ) ^ 2 ) / N )
+// ***********************************************************************************
+struct _SDS011_Statistics {
+  int      N ;
+  float    Mean_x, Mean_y, M2_x, M2_y, C_xy ;
+  uint16_t Min, Max ;
+
+  void Reset () {
+    N      = 0 ;
+    Mean_x = Mean_y = M2_x = M2_y = C_xy = 0 ;
+    Min    = 0xFFFF ;
+    Max    = 0 ;
+  }
+
+  // Value in units of 0.1 ug/m3, as send by the sensor
+  void Add ( uint16_t Value ) {
+    float y  = 0.1 * Value ;
+    float x  = N ;
+    N       += 1 ;
+    float dx = x - Mean_x ;
+    float dy = y - Mean_y ;
+    Mean_x  += dx / N ;
+    Mean_y  += dy / N ;
+    M2_x    += dx * ( x - Mean_x ) ;
+    M2_y    += dy * ( y - Mean_y ) ;
+    C_xy    += dx * ( y - Mean_y ) ;
+    if ( Value < Min ) { Min = Value ; }
+    if ( Value > Max ) { Max = Value ; }
+  }
+
+  float SD () { return ( N > 0 ) ? sqrt ( M2_y / N ) : 0 ; }
+  // a single sample ( working period mode ) has no slope
+  float B1 () { return ( M2_x > 0 ) ? C_xy / M2_x : 0 ; }
+} ;
+
+// ***********************************************************************************
+// Command transactions: a command is repeated until the sensor echoes it ( C5 reply )
+// ***********************************************************************************
+#define SDS011_MAX_TRANSACTIONS    8
+#define SDS011_REPLY_TIMEOUT_MS    500
+#define SDS011_WAKE_TIMEOUT_MS     1000
+#define SDS011_RETRIES             3
+
+struct _SDS011_Transaction {
+  _SDS011_Command Command ;
+  uint8_t         Retries ;
+} ;
+
+// ***********************************************************************************
+// Called for every sample during a burst, see Burst_Enable
+// ***********************************************************************************
+class _Sensor_SDS011 ;
+void ( *SDS011_Burst_Callback ) ( _Sensor_SDS011 &Sensor ) = NULL ;
+
+// ***********************************************************************************
+// Called for every accepted sample ( PM_2_5, PM_10 ),
+//   and at the end of every working period with the means and the number of samples
+// ***********************************************************************************
+void ( *SDS011_Sample_Callback ) ( _Sensor_SDS011 &Sensor ) = NULL ;
+void ( *SDS011_Window_Callback ) ( _Sensor_SDS011 &Sensor, int N, float PM_2_5, float PM_10 ) = NULL ;
+
+// ***********************************************************************************
+// The sensor that sets the schedule, a sensor with a phase ( Set_Phase ) follows it,
+//   set by _Sensor_SDS011_N < 0 >
+// ***********************************************************************************
+_Sensor_SDS011 *SDS011_Phase_Leader = NULL ;
 
 // ***********************************************************************************
 // The Class Name should always start with "_Sensor_" followed by the sensortype
@@ -66,24 +196,81 @@ class _Sensor_SDS011 {
                                             // So if you make the pause 5 times larger than the working time,
                                             // the expected lifetime of the laser will be about 6 years.
     int      Sample_Time_ms  = 1000 ;       // The time between consecutive samples
-                                            // During workingtime, samples are gathered in an array and
+                                            // During workingtime, samples are added to running statistics and
                                             // at the end of the workingtime, 
                                             // the mean value (and some other statistics) are calculated.
                                             // after that a new JSON string is build
     int      Start_Sample    = 1 ;          // The first few samples of the workingtime might be better ignored.
+    int      Mode            = SDS011_MODE_ACTIVE ;   // see Set_Mode
+    bool     Awake           = false ;      // confirmed by the sensor
+    unsigned long Commands_OK     = 0 ;
+    unsigned long Commands_Failed = 0 ;
+    bool     Auto_Window     = false ;      // automatic warm-up detection and early end of the working period
+    int      Warmup_Max_Samples = 15 ;      //   maximum number of warm-up samples
+    int      Auto_Min_Samples   = 5 ;       //   minimum number of samples in a working period
+    float    Warmup_Abs      = 0.5 ;        //   tolerance [ug/m3] = Warmup_Abs + Warmup_Rel * mean
+    float    Warmup_Rel      = 0.05 ;
+    bool     Adaptive        = false ;      // adaptive duty cycle, the pause time depends on the variability
+    int      Pause_Min_ms    = 60000 ;      // limits of the pause time in adaptive mode
+    int      Pause_Max_ms    = 900000 ;
+    float    Stable_SD       = 2.0 ;        // PM2.5 [ug/m3] below this SD and
+    float    Stable_B1       = 0.05 ;       //   slope [ug/m3 per sample] below this is stable
+    float    Rising_B1       = 0.2 ;        // slope above this is rising
+    unsigned long Laser_On_s = 0 ;          // cumulative on-time of the laser
+    _History *History        = NULL ;       // on-device history, see History.h
+    bool     Outlier_Filter  = false ;      // reject outliers and duplicate frames
+    int      Rejected        = 0 ;          //   rejected samples in the last working period
+    unsigned long Rejected_Total = 0 ;
+    bool     Burst_Enable    = false ;      // burst mode, every sample is reported during a spike
+    bool     Burst           = false ;      //   burst active
+    float    Burst_On_PM     = 50 ;         //   PM2.5 [ug/m3] that starts a burst
+    float    Burst_Off_PM    = 35 ;         //   PM2.5 [ug/m3] that stops a burst
+    float    Burst_On_B1     = 1.0 ;        //   slope [ug/m3 per sample] that starts a burst
+    unsigned long Burst_Max_ms      = 600000 ; // maximum duration of a burst
+    unsigned long Burst_Hold_Off_ms = 600000 ; // minimum time between 2 bursts
+    unsigned long Burst_Count       = 0 ;
+    unsigned long Window_Count      = 0 ;  // number of completed working periods
+    int      Window_Samples  = 0 ;          //   samples in the last working period
+    unsigned long Duplicate_Frames = 0 ;    // frames dropped as a repetition of the previous frame
+    bool     Multiple        = false ;      // more SDS011 sensors on this node
     float    PM_2_5          = 0 ;
     float    PM_10           = 0 ;
   
     // ***********************************************************************
     // The sensor uses sofware serial port, 
     //   so you have to provide the hardware pins
-    // Here an instance of the sensor is created and 
-    //   the software serial port is also created and started right away.
+    // The serial port is opened on the first call of loop,
+    //   so it doesn't depend on the order of the global constructors.
     // ***********************************************************************
     _Sensor_SDS011 ( int RX, int TX ) {
-      const bool Inverted = false ;
-      _serialSDS          = new SoftwareSerial  ( RX, TX, Inverted, 128 ) ;
-      _serialSDS          -> begin ( 9600 ) ;
+      _RX = RX ;
+      _TX = TX ;
+      _Stat_PM_2_5.Reset () ;
+      _Stat_PM_10 .Reset () ;
+    }
+
+    // ***********************************************************************
+    // The sensor uses an already opened port,
+    //   e.g. a hardware UART or a simulated sensor
+    // ***********************************************************************
+    _Sensor_SDS011 ( Stream &Port ) {
+      _serialSDS = &Port ;
+      _Stat_PM_2_5.Reset () ;
+      _Stat_PM_10 .Reset () ;
+    }
+
+    // ***********************************************************************
+    // Default constructor, used by the sensor registry,
+    //   the port is selected by SDS_SERIAL and the pins are taken from ext_def.h
+    // ***********************************************************************
+    _Sensor_SDS011 () : _Sensor_SDS011 ( SDS_PIN_RX, SDS_PIN_TX, SDS_SERIAL == SERIAL_TRANSPORT_HARDWARE ) {
+    }
+
+    // ***********************************************************************
+    // Soft serial pins, or the hardware UART ( the pins are then ignored )
+    // ***********************************************************************
+    _Sensor_SDS011 ( int RX, int TX, bool Hardware_UART ) : _Sensor_SDS011 ( RX, TX ) {
+      _Hardware_UART = Hardware_UART ;
     }
 
     // ***********************************************************************
@@ -110,6 +297,39 @@ class _Sensor_SDS011 {
     // ***********************************************************************
     void loop () {
       unsigned long Now = millis ();
+
+      // ******************************************
+      // open the serial port on the first call
+      // ******************************************
+      if ( _serialSDS == NULL ) {
+        if ( _Hardware_UART ) {
+          _serialSDS = _Serial_Transport::Hardware ( 9600 ) ;
+        }
+        else {
+          _serialSDS = _Serial_Transport::Software ( _RX, _TX, 9600 ) ;
+        }
+      }
+
+      // *************************************************
+      // handle all received frames and pending commands
+      // *************************************************
+      _Poll () ;
+      _Transaction_Loop ( Now ) ;
+
+      // ****************************************************************
+      // In working period mode the sensor runs its own duty cycle,
+      //   it wakes up, measures 30 seconds, sends one frame and sleeps.
+      // Each frame is a complete measurement.
+      // ****************************************************************
+      if ( Mode == SDS011_MODE_PERIOD ) {
+        if ( _Data_Len > 0 ) {
+          _Store_Sample () ;
+          _Add_Laser_On_Time ( 30000 ) ;
+          _Process_Window ( Now ) ;
+        }
+        return ;
+      }
+
       // *******************************
       // State = 0 is the sleeping state
       // *******************************
@@ -118,16 +338,21 @@ class _Sensor_SDS011 {
         // *****************************************************
         // test if pause time is passed, go to the working state
         // *****************************************************
-        if ( ( Now - _Last_Get_Data ) > Pause_Time_ms ){
+        if ( ( Now - _Last_Get_Data ) > (unsigned long) Pause_Time_ms ){
           _Last_Get_Data += Pause_Time_ms ;
           _State = 1 ;
+          _Wake_Time = Now ;
+          _Warming_Up = true ;
 
           // ***************************************************************************
           // this command starts the sensor (i.e. the laserdiode and the ventilator) and
           // while the sensor is working, it will send continuously the measured data
+          // (in query mode, it only sends data on request)
           // ***************************************************************************
-          uint8_t Start_cmd[] = {0xAA, 0xB4, 0x06, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x06, 0xAB};
-          _serialSDS -> write ( Start_cmd, sizeof ( Start_cmd ) ); 
+          _Queue_Command_P ( &SDS011_CMD_WORK ) ;
+          _Data_Len = 0 ;
+          _Filter_PM_2_5.Reset () ;
+          _Filter_PM_10 .Reset () ;
         }
       }
       else {
@@ -136,208 +361,574 @@ class _Sensor_SDS011 {
         // Test if sample time has passed, and if so, 
         // take a sample and test if this is the end of the working period
         // ***************************************************************
-        if ( ( Now - _Last_Sample_Time ) > Sample_Time_ms ){
+        if ( ( Now - _Last_Sample_Time ) > (unsigned long) Sample_Time_ms ){
           _Last_Sample_Time += Sample_Time_ms ;
 
-          // ************* 
-          // take a sample
-          // ************* 
-          _Get_Response ( 0x04 );
-          PM_2_5 = 256 * _Data[1] + _Data[0] ;
-          PM_10  = 256 * _Data[3] + _Data[2] ;
-          //Print_CMD ( _Data, _Data_Len ) ;
-
-          // ****************************
-          // Store sample in sample array
-          // ****************************
-          _Sample_Array_PM_2_5 [ _N_Sample ] = PM_2_5 ;
-          _Sample_Array_PM_10  [ _N_Sample ] = PM_10  ;
-          _N_Sample += 1 ;
+          // ********************************************************
+          // take a sample, if a new frame is received
+          // in query mode, that's the answer on the query of the
+          //   previous sample time, and a new query is sent
+          // ********************************************************
+          if ( ( _Data_Len > 0 ) && _Store_Sample () ) {
+            _Burst_Sample ( Now ) ;
+          }
+          if ( Mode == SDS011_MODE_QUERY ) {
+            _Send_Command_P ( &SDS011_CMD_QUERY ) ;
+          }
   
           // ***************************************************
           // test of the working period has passed
           // and if so, do calculation and go to the pause state
+          // ( during a burst, the sensor stays awake )
           // ***************************************************
-          if ( ( Now - _Last_Get_Data ) > Working_Time_ms  ){
+          if ( ( ( Now - _Last_Get_Data ) > (unsigned long) Working_Time_ms ) || ( ! Burst && _Window_Complete () ) ){
             //_Last_Get_Data += Working_Time_ms ;   
             _Last_Get_Data = Now ;
-            _State = 0 ;
-            int N_Sample = _N_Sample - Start_Sample ;
-
-            // ********************** 
-            // stop the SDS011 sensor
-            // ********************** 
-            uint8_t Stop_cmd[]  = {0xAA, 0xB4, 0x06, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x05, 0xAB};
-            _serialSDS -> write ( Stop_cmd, sizeof ( Stop_cmd ) ); 
-
-            // **********************************************
-            // if too few samples, ignore this working period
-            // **********************************************
-            if ( _N_Sample < ( Start_Sample + 1 ) ) {
-              _N_Sample = 0 ;
-            }
+            _Add_Laser_On_Time ( Now - _Wake_Time ) ;
+            _Wake_Time = Now ;
 
-            // ****************************
-            // build new _JSON_String and
-            // calculate statistics
-            // ****************************
-            int Max_PM_2_5 = 0 ;
-            int Min_PM_2_5 = 1000000 ;
-            int Sum_PM_2_5 = 0 ;
-            int Max_PM_10  = 0 ;
-            int Min_PM_10  = 1000000 ;
-            int Sum_PM_10  = 0 ;
-
-            // *************************************************************
-            // the first few samples, indicated by Start_Sample, are ignored
-            // calculate mean, min, max
-            // *************************************************************
-            for ( int i = Start_Sample; i < _N_Sample; i++ ) {
-              //Max_PM_2_5 = max ( Max_PM_2_5, _Sample_Array_PM_2_5 [i] ) ;   DOESNT WORK HERE ???
-              //Min_PM_2_5 = min ( Min_PM_2_5, _Sample_Array_PM_2_5 [i] ) ;
-              if ( _Sample_Array_PM_2_5 [i] > Max_PM_2_5 ) { Max_PM_2_5 = _Sample_Array_PM_2_5 [i] ; }
-              if ( _Sample_Array_PM_2_5 [i] < Min_PM_2_5 ) { Min_PM_2_5 = _Sample_Array_PM_2_5 [i] ; }
-              Sum_PM_2_5 += _Sample_Array_PM_2_5 [i] ;
-              
-              //max_PM_10  = max ( max_PM_10, _Sample_Array_PM_10 [i] ) ;
-              //min_PM_10  = min ( min_PM_10, _Sample_Array_PM_10 [i] ) ;
-              if ( _Sample_Array_PM_10 [i] > Max_PM_10 ) { Max_PM_10 = _Sample_Array_PM_10 [i] ; }
-              if ( _Sample_Array_PM_10 [i] < Min_PM_10 ) { Min_PM_10 = _Sample_Array_PM_10 [i] ; }
-              Sum_PM_10  += _Sample_Array_PM_10 [i] ;
-            }
+            _Process_Window ( Now ) ;
+            _Update_Burst   ( Now ) ;
+
+            if ( ! Burst ) {
+              _State = 0 ;
 
-            // ******************************************************
-            // now we have mean, we can calulate the linear regression
-            //    y = B0 + B1 * x
-            //    B1 = SUM ( ( x[i] - MEAN(x) ) * ( y[i] - MEAN(y) ) )
-            //    B0 = MEAN(y) - ( B1 * MEAN(x) )
-            //    B0, we don't need it, because it's directly correlated with the mean of the signal
-            // and the standaard deviation
-            //    SD = SQRT ( VARIANCE )
-            //    VARIANCE = SUM ( ( y[i] - MEAN(Y) ) ^ 2 )
-            // and ....  ?
-            // ******************************************************
-            //float B0_PM_2_5 ;
-            float B1_PM_2_5      = 0 ;
-            float SD_PM_2_5      = 0 ;
-            float Mean_x_PM_2_5  = N_Sample / 2 ;
-            float Mean_y_PM_2_5  = 0.1 * Sum_PM_2_5 / N_Sample ;
-            float Sum_dx2_PM_2_5 = 0 ;
-
-            float B1_PM_10      = 0 ;
-            float SD_PM_10      = 0 ;
-            float Mean_x_PM_10  = N_Sample / 2 ;
-            float Mean_y_PM_10  = 0.1 * Sum_PM_10 / N_Sample ;
-            float Sum_dx2_PM_10 = 0 ;
-
-            for ( int i = Start_Sample; i < _N_Sample; i++ ) {
-              B1_PM_2_5      +=    ( i - Start_Sample - Mean_x_PM_2_5 ) * ( 0.1 * _Sample_Array_PM_2_5 [i] - Mean_y_PM_2_5 ); 
-              Sum_dx2_PM_2_5 += sq ( i - Start_Sample - Mean_x_PM_2_5 ) ;
-              SD_PM_2_5      += sq ( 0.1 * _Sample_Array_PM_2_5 [i] - Mean_y_PM_2_5 ) ;
-
-              B1_PM_10       +=    ( i - Start_Sample - Mean_x_PM_10 ) * ( 0.1 * _Sample_Array_PM_10 [i] - Mean_y_PM_10 ); 
-              Sum_dx2_PM_10  += sq ( i - Start_Sample - Mean_x_PM_10 ) ;
-              SD_PM_10       += sq ( 0.1 * _Sample_Array_PM_10 [i] - Mean_y_PM_10 ) ;
+              // ********************** 
+              // stop the SDS011 sensor
+              // ********************** 
+              _Queue_Command_P ( &SDS011_CMD_SLEEP ) ;
+              _Adapt_Pause_Time () ;
+              _Follow_Leader    ( Now ) ;
             }
-            B1_PM_2_5 /= Sum_dx2_PM_2_5 ;
-            //B0_PM_2_5 = Mean_y_PM_2_5 - ( B1_PM_2_5 * Mean_x_PM_2_5 ) ;
-            SD_PM_2_5 /=  N_Sample ;
-            SD_PM_2_5  = sqrt ( SD_PM_2_5 ) ;
-            
-            B1_PM_10 /= Sum_dx2_PM_10 ;
-            SD_PM_10 /= N_Sample ;
-            SD_PM_10  = sqrt ( SD_PM_10 ) ;
-
-            // **********************************************************************
-            // print a tab delimited string containing all relevant values
-            // you can use this data from a serial monitor and use this as a csv file
-            // **********************************************************************
-            sprintf ( msg, "%d\t%d\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f", 
-                           Now, N_Sample, 
-                           Mean_y_PM_2_5, Mean_y_PM_10, 
-                           SD_PM_2_5, SD_PM_10, 
-                           0.1 * Min_PM_2_5, 0.1 * Max_PM_2_5, 
-                           0.1 * Min_PM_10, 0.1 * Max_PM_10, 
-                           B1_PM_2_5, B1_PM_10 ) ;
-            debug_out ( msg, DEBUG_WARNING, true );
-            
-            // *************************************************
-            // and here the JSON string to send to all web api's
-            // *************************************************
-            sprintf ( msg, "{\"value_type\":\"SDS_P1\",\"value\":\"%.2f\"},{\"value_type\":\"SDS_P2\",\"value\":\"%.2f\"},",
-                       Mean_y_PM_10, Mean_y_PM_2_5 ) ;
-            _JSON_Sample = msg ;
-
-            // ****************************************
-            // Don't forget to reset the buffer pointer
-            // ****************************************
-            _N_Sample = 0;
           }
         }
       }
     }
-    
+
     // ***********************************************************************
-    // Get version of device-firmware and the unique device-ID 
-    // these values ar stored in Device_Firmware and Device_ID
-    // The function itself returns a string containing both in a readable way.
+    // Select the driver mode, called once by the constructor of _Sensor_SDS011_N
+    //   SDS011_MODE_ACTIVE : sensor sends a frame every second while awake
+    //   SDS011_MODE_QUERY  : sensor only sends a frame on request
+    //   SDS011_MODE_PERIOD : sensor firmware runs its own duty cycle,
+    //                        one measurement every Period_Minutes ( 1 .. 30 )
+    // The settings are stored in the sensor itself,
+    //   so they are always sent, to undo any previous setting.
+    // The commands are queued, so this function doesn't block.
     // ***********************************************************************
-    String Get_Version () {
-      uint8_t Version_Cmd[] = {0xAA, 0xB4, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x05, 0xAB};
+    void Set_Mode ( int New_Mode, int Period_Minutes = 1 ) {
+      Mode = New_Mode ;
+      Period_Minutes = constrain ( Period_Minutes, 1, 30 ) ;
 
-      // *******************************
-      // The next delay is necessary to 
-      // let this function work correctly if it is called from the setup part.
-      // *******************************
-      delay ( 500 ) ;
-      
-      _serialSDS -> write ( Version_Cmd, sizeof ( Version_Cmd )); 
-    
-      // *************************************************
-      // met een te kleine delay (0, 10, 50, 70) lukt het niet
-      //   80 doet het meestal wel
-      // ===>>>  100 msec doet het zeker
-      // grote delays (maar wat is de zin hiervan) 
-      //     doen het ook (uitgeprobeerd tot 2000)
-      // *************************************************
-      delay ( 100 ) ;
-      _Get_Response ( Version_Cmd[2] );
+      // ***************************************
+      // Reporting mode: 0 = active, 1 = query
+      // ***************************************
+      _Queue_Command ( SDS011_Set_Reporting_Mode ( Mode == SDS011_MODE_QUERY ) ) ;
+
+      // ***************************************************
+      // Working period: 0 = continuous, 1 .. 30 minutes
+      // ***************************************************
+      _Queue_Command ( SDS011_Set_Working_Period ( ( Mode == SDS011_MODE_PERIOD ) ? Period_Minutes : 0 ) ) ;
 
-      _Print_CMD ( _Data, _Data_Len ) ;
+      if ( Mode == SDS011_MODE_PERIOD ) {
+        Working_Time_ms = 30000 ;
+        Pause_Time_ms   = 60000 * Period_Minutes - Working_Time_ms ;
+      }
 
-      Device_Firmware = "20" ;
-      Device_Firmware += String ( _Data[1], 10 ) + "." ;
-      Device_Firmware += String ( _Data[2], 10 ) + "." ;
-      Device_Firmware += String ( _Data[3], 10 ) ;
+      // ***************************************************************
+      // we start in the working state, but the sensor may still sleep
+      //   ( e.g. after a reset or a deep sleep of the ESP )
+      // ***************************************************************
+      _Queue_Command_P ( &SDS011_CMD_WORK ) ;
+    }
 
-      Device_ID = 256 * _Data[4] + _Data[5] ;
+    // ***********************************************************************
+    // Request version of device-firmware and the unique device-ID 
+    // The request is queued and doesn't block,
+    //   as soon as the sensor answers, the values are stored in Device_Firmware and Device_ID
+    // ***********************************************************************
+    void Request_Version () {
+      _Queue_Command_P ( &SDS011_CMD_FIRMWARE ) ;
+    }
 
+    // ***********************************************************************
+    // Returns a string containing Device_Firmware and Device_ID in a readable way.
+    // ***********************************************************************
+    String Get_Version () {
       sprintf ( msg, "Device-Firmware = %s    Device-ID = %s", Device_Firmware.c_str(),
                                                                String ( Device_ID, HEX ).c_str() ) ;
-      debug_out ( msg, DEBUG_MAX_INFO, true );
       return msg ;
     }
 
+    // ***********************************************************************
+    // The value_type prefix in the JSON string
+    //   "SDS_" for a single sensor ( as expected by Luftdaten ),
+    //   "SDS_<Device-ID>_" if there are more sensors on this node
+    // ***********************************************************************
+    String Get_JSON_Prefix () {
+      if ( ! Multiple ) {
+        return "SDS_" ;
+      }
+      return "SDS_" + String ( Device_ID, HEX ) + "_" ;
+    }
+
+    // ***********************************************************************
+    // Start with a sleeping sensor that wakes up at Offset_ms,
+    //   used to stagger the working periods of more sensors.
+    // After each working period the sensor wakes up again Offset_ms after
+    //   SDS011_Phase_Leader, with the pause time of that sensor,
+    //   so the stagger stays when the leader adapts its pause time.
+    // ***********************************************************************
+    void Set_Phase ( unsigned long Offset_ms ) {
+      if ( ( Offset_ms == 0 ) || ( Mode == SDS011_MODE_PERIOD ) ) {
+        return ;
+      }
+      _Phase_Offset_ms = Offset_ms ;
+      _State           = 0 ;
+      _Last_Get_Data   = Offset_ms - Pause_Time_ms ;
+      _Queue_Command_P ( &SDS011_CMD_SLEEP ) ;
+    }
+
+    // ***********************************************************************
+    // The frame parser, for its counters ( Frames_OK, Checksum_Errors, Sync_Errors )
+    // ***********************************************************************
+    const _Frame_Parser < _Frame_SDS011 > &Parser () {
+      return _Parser ;
+    }
+
+    // ***********************************************************************
+    // Time until loop has something to do, 0 if loop should be called now
+    //   ( e.g. data is received ), the main loop can idle until then.
+    // Received data stays in the receive buffer of the serial port.
+    // ***********************************************************************
+    unsigned long Next_Event_ms ( unsigned long Now ) {
+      if ( ( _serialSDS == NULL ) || ( _serialSDS->available () > 0 ) ) {
+        return 0 ;
+      }
+      unsigned long Next = IDLE_MAX_MS ;
+      if ( _N_Transaction > 0 ) {
+        if ( ! _Transaction_Sent ) {
+          return 0 ;
+        }
+        Next = min ( Next, Remaining_ms ( Now, _Transaction_Time, SDS011_REPLY_TIMEOUT_MS ) ) ;
+      }
+      if ( Mode == SDS011_MODE_PERIOD ) {
+        return Next ;
+      }
+      if ( _State == 0 ) {
+        return min ( Next, Remaining_ms ( Now, _Last_Get_Data, Pause_Time_ms ) ) ;
+      }
+      Next = min ( Next, Remaining_ms ( Now, _Last_Sample_Time, Sample_Time_ms ) ) ;
+      return min ( Next, Remaining_ms ( Now, _Last_Get_Data, Working_Time_ms ) ) ;
+    }
+
+    // ***********************************************************************
+    // true if the sensor is in its pause ( not in working period mode )
+    // ***********************************************************************
+    bool Sleeping () {
+      return ( Mode != SDS011_MODE_PERIOD ) && ( _State == 0 ) ;
+    }
+
+    // ***********************************************************************
+    // time until the next working period
+    // ***********************************************************************
+    unsigned long Pause_Remaining_ms ( unsigned long Now ) {
+      unsigned long Paused = Now - _Last_Get_Data ;
+      return ( Paused < (unsigned long) Pause_Time_ms ) ? Pause_Time_ms - Paused : 0 ;
+    }
+
+    // ***********************************************************************
+    // The state that should survive a deep sleep of the ESP, see RTC_State.h
+    // The working period has ended before a deep sleep,
+    //   so only the result of the last working period is kept.
+    // ***********************************************************************
+    void Save_State ( _RTC_SDS011 &State ) {
+      State.Pause_Time_ms    = Pause_Time_ms ;
+      State.Laser_On_s       = Laser_On_s ;
+      State.Laser_On_Rest_ms = _Laser_On_Rest_ms ;
+      State.Rejected_Total   = Rejected_Total ;
+      State.Burst_Count      = Burst_Count ;
+      State.Last_N           = _Last_N ;
+      State.Last_Mean        = _Last_Mean ;
+      State.Last_SD          = _Last_SD ;
+      State.Last_B1          = _Last_B1 ;
+      State.Previous_Mean    = _Previous_Mean ;
+    }
+
+    void Restore_State ( const _RTC_SDS011 &State ) {
+      if ( State.Pause_Time_ms > 0 ) {
+        Pause_Time_ms = State.Pause_Time_ms ;
+      }
+      Laser_On_s        = State.Laser_On_s ;
+      _Laser_On_Rest_ms = State.Laser_On_Rest_ms ;
+      Rejected_Total    = State.Rejected_Total ;
+      Burst_Count       = State.Burst_Count ;
+      _Last_N           = State.Last_N ;
+      _Last_Mean        = State.Last_Mean ;
+      _Last_SD          = State.Last_SD ;
+      _Last_B1          = State.Last_B1 ;
+      _Previous_Mean    = State.Previous_Mean ;
+    }
+
+    // ***********************************************************************
+    // true as long as there are commands waiting for an answer
+    // ***********************************************************************
+    bool Commands_Pending () {
+      return _N_Transaction > 0 ;
+    }
+
 
   // ***********************************************************************
   private:
   // ***********************************************************************
     uint8_t       _Data [ 20 ] ;
-    uint16_t      _Sample_Array_PM_2_5 [ 1000 ] ;
-    uint16_t      _Sample_Array_PM_10  [ 1000 ] ;
+    _SDS011_Statistics _Stat_PM_2_5 ;
+    _SDS011_Statistics _Stat_PM_10 ;
+    _Outlier_Filter < SDS011_FILTER_WINDOW > _Filter_PM_2_5 ;
+    _Outlier_Filter < SDS011_FILTER_WINDOW > _Filter_PM_10 ;
+    int           _Rejected         = 0 ;
+    unsigned long _Data_Time        = 0 ;
     int           _N_Sample         = 0 ;
     int           _Data_Len         = 0 ;
     int           _State            = 1 ;
+    _SDS011_Transaction _Transaction [ SDS011_MAX_TRANSACTIONS ] ;
+    int           _First_Transaction = 0 ;
+    int           _N_Transaction     = 0 ;
+    bool          _Transaction_Sent  = false ;
+    unsigned long _Transaction_Time  = 0 ;
     unsigned long _Last_Get_Data    = 0 ;
+    unsigned long _Phase_Offset_ms  = 0 ;
     unsigned long _Last_Sample_Time = 0 ;
+    unsigned long _Wake_Time        = 0 ;
+    bool          _Warming_Up       = true ;
+    uint16_t      _Warmup [ SDS011_WARMUP_K ] ;
+    unsigned long _Laser_On_Rest_ms = 0 ;
+    int           _Last_N           = 0 ;
+    float         _Last_Mean        = 0 ;
+    float         _Last_SD          = 0 ;
+    float         _Last_B1          = 0 ;
+    float         _Previous_Mean    = 0 ;
+    unsigned long _Burst_Start      = 0 ;
+    unsigned long _Burst_Stop       = 0 ;
     String        _JSON_Sample      = "" ;
 
     // *****************************************************
-    // Because Software Serial is a of abstract type Stream
-    //   We have to declare it as pointer
+    // The serial port, see Serial_Transport.h
     // *****************************************************
-    SoftwareSerial *_serialSDS ;
+    Stream       *_serialSDS     = NULL ;
+    int           _RX            = -1 ;
+    int           _TX            = -1 ;
+    bool          _Hardware_UART = false ;
+
+    _Frame_Parser < _Frame_SDS011 > _Parser ;
+    // ***********************************************************************
+
+    // ***********************************************************************
+    // Send a command to the sensor, see SDS011_Command.h
+    // _P : the command is stored in flash
+    // ***********************************************************************
+    void _Send_Command ( const _SDS011_Command &Command ) {
+      _serialSDS -> write ( Command.Bytes, SDS011_COMMAND_LEN ); 
+    }
+
+    void _Send_Command_P ( const _SDS011_Command *Command ) {
+      _SDS011_Command Buffer ;
+      memcpy_P ( &Buffer, Command, sizeof ( Buffer ) ) ;
+      _Send_Command ( Buffer ) ;
+    }
+
+    // ***********************************************************************
+    // Add the last received data to the statistics
+    // The first few samples of a working period, indicated by Start_Sample, are ignored
+    //   ( not in working period mode, there each frame is a complete measurement )
+    // Returns false if the sample is rejected as an outlier
+    //   ( _Data_Len is only set by a new frame, duplicate frames are dropped by _Poll )
+    // ***********************************************************************
+    bool _Store_Sample () {
+      _Data_Len = 0 ;
+      //Print_CMD ( _Data, _Data_Len ) ;
+      uint16_t New_PM_2_5 = 256 * _Data[1] + _Data[0] ;
+      uint16_t New_PM_10  = 256 * _Data[3] + _Data[2] ;
+
+      // ***************************************************************
+      // outlier rejection, both filters must see every sample
+      //   ( not in working period mode, 1 sample per period is too few )
+      // ***************************************************************
+      if ( Outlier_Filter && ( Mode != SDS011_MODE_PERIOD ) ) {
+        bool OK = _Filter_PM_2_5.Accept ( New_PM_2_5 ) ;
+        OK = _Filter_PM_10 .Accept ( New_PM_10  ) && OK ;
+        if ( ! OK ) {
+          _Reject_Sample () ;
+          return false ;
+        }
+      }
+      PM_2_5 = New_PM_2_5 ;
+      PM_10  = New_PM_10 ;
+      if ( SDS011_Sample_Callback != NULL ) {
+        SDS011_Sample_Callback ( *this ) ;
+      }
+
+      _N_Sample += 1 ;
+
+      // *************************************************************
+      // automatic warm-up detection, instead of a fixed Start_Sample
+      // *************************************************************
+      if ( Auto_Window && ( Mode != SDS011_MODE_PERIOD ) ) {
+        if ( _Warming_Up ) {
+          _Warmup [ ( _N_Sample - 1 ) % SDS011_WARMUP_K ] = PM_2_5 ;
+          if ( ! _Warmup_Done () ) {
+            return true ;
+          }
+          _Warming_Up = false ;
+        }
+      }
+      else {
+        int First = ( Mode == SDS011_MODE_PERIOD ) ? 0 : Start_Sample ;
+        if ( _N_Sample <= First ) {
+          return true ;
+        }
+      }
+      _Stat_PM_2_5.Add ( PM_2_5 ) ;
+      _Stat_PM_10 .Add ( PM_10  ) ;
+      if ( History != NULL ) {
+        History -> Add ( millis (), PM_2_5, PM_10 ) ;
+      }
+      return true ;
+    }
+
+    void _Reject_Sample () {
+      _Rejected      += 1 ;
+      Rejected_Total += 1 ;
+    }
+
+    // ***********************************************************************
+    // The warm-up is done as soon as the last SDS011_WARMUP_K samples
+    //   have a slope and a standard deviation within the tolerance,
+    //   tolerance = Warmup_Abs + Warmup_Rel * mean
+    // or after Warmup_Max_Samples samples.
+    // ***********************************************************************
+    bool _Warmup_Done () {
+      if ( _N_Sample >= Warmup_Max_Samples ) {
+        return true ;
+      }
+      if ( _N_Sample < SDS011_WARMUP_K ) {
+        return false ;
+      }
+      // ***************************************************************
+      // the order in the ring doesn't matter for the mean and SD,
+      //   for the slope the samples are taken from oldest to newest
+      // ***************************************************************
+      float Mean = 0 ;
+      for ( int i = 0; i < SDS011_WARMUP_K; i++ ) {
+        Mean += 0.1 * _Warmup [i] ;
+      }
+      Mean /= SDS011_WARMUP_K ;
+
+      float Mean_x = 0.5 * ( SDS011_WARMUP_K - 1 ) ;
+      float Sum_xy = 0 ;
+      float Sum_x2 = 0 ;
+      float Sum_y2 = 0 ;
+      for ( int i = 0; i < SDS011_WARMUP_K; i++ ) {
+        float y = 0.1 * _Warmup [ ( _N_Sample + i ) % SDS011_WARMUP_K ] - Mean ;
+        Sum_xy += ( i - Mean_x ) * y ;
+        Sum_x2 += sq ( i - Mean_x ) ;
+        Sum_y2 += sq ( y ) ;
+      }
+      float Tolerance = Warmup_Abs + Warmup_Rel * Mean ;
+      float Drift     = fabs ( Sum_xy / Sum_x2 ) * SDS011_WARMUP_K ;
+      float SD        = sqrt ( Sum_y2 / SDS011_WARMUP_K ) ;
+      return ( Drift < Tolerance ) && ( SD < Tolerance ) ;
+    }
+
+    // ***********************************************************************
+    // The working period can stop early, when the 95% confidence interval
+    //   of the mean PM2.5 is smaller than +/- ( Warmup_Abs + Warmup_Rel * mean )
+    // ***********************************************************************
+    bool _Window_Complete () {
+      if ( ! Auto_Window || _Warming_Up || ( _Stat_PM_2_5.N < Auto_Min_Samples ) ) {
+        return false ;
+      }
+      float Half_Width = 1.96 * _Stat_PM_2_5.SD () / sqrt ( _Stat_PM_2_5.N ) ;
+      return Half_Width < ( Warmup_Abs + Warmup_Rel * _Stat_PM_2_5.Mean_y ) ;
+    }
+
+    // ***********************************************************************
+    // End of a working period: get the statistics and build a new JSON string
+    // ***********************************************************************
+    void _Process_Window ( unsigned long Now ) {
+      LOOP_TIME ( STAGE_STATISTICS ) ;
+      int N_Sample = _Stat_PM_2_5.N ;
+      Window_Samples = N_Sample ;
+      Rejected  = _Rejected ;
+      _Rejected = 0 ;
+      Window_Count += 1 ;
+
+      // **********************************************
+      // if too few samples, ignore this working period
+      // **********************************************
+      if ( N_Sample < 1 ) {
+        _N_Sample = 0 ;
+        return ;
+      }
+
+      float Mean_y_PM_2_5 = _Stat_PM_2_5.Mean_y ;
+      float Mean_y_PM_10  = _Stat_PM_10 .Mean_y ;
+
+      // *************************************
+      // remember for the adaptive duty cycle
+      // *************************************
+      _Last_N    = N_Sample ;
+      _Last_Mean = Mean_y_PM_2_5 ;
+      _Last_SD   = _Stat_PM_2_5.SD () ;
+      _Last_B1   = _Stat_PM_2_5.B1 () ;
+
+      // **********************************************************************
+      // print a tab delimited string containing all relevant values
+      // you can use this data from a serial monitor and use this as a csv file
+      // **********************************************************************
+      sprintf ( msg, "%d\t%d\t%d\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f", 
+                     Now, N_Sample, Rejected, 
+                     Mean_y_PM_2_5, Mean_y_PM_10, 
+                     _Stat_PM_2_5.SD (), _Stat_PM_10.SD (), 
+                     0.1 * _Stat_PM_2_5.Min, 0.1 * _Stat_PM_2_5.Max, 
+                     0.1 * _Stat_PM_10.Min,  0.1 * _Stat_PM_10.Max, 
+                     _Stat_PM_2_5.B1 (), _Stat_PM_10.B1 () ) ;
+      debug_out ( msg, DEBUG_WARNING, true );
+      
+      // *************************************************
+      // and here the JSON string to send to all web api's
+      // *************************************************
+      String Prefix = Get_JSON_Prefix () ;
+      sprintf ( msg, "{\"value_type\":\"%sP1\",\"value\":\"%.2f\"},{\"value_type\":\"%sP2\",\"value\":\"%.2f\"},",
+                 Prefix.c_str(), Mean_y_PM_10, Prefix.c_str(), Mean_y_PM_2_5 ) ;
+      _JSON_Sample = msg ;
+
+      if ( SDS011_Window_Callback != NULL ) {
+        SDS011_Window_Callback ( *this, N_Sample, Mean_y_PM_2_5, Mean_y_PM_10 ) ;
+      }
+
+      // **************************************
+      // Don't forget to reset the statistics
+      // **************************************
+      _N_Sample = 0;
+      _Stat_PM_2_5.Reset () ;
+      _Stat_PM_10 .Reset () ;
+    }
+
+    // ***********************************************************************
+    // Adaptive duty cycle, called at the end of each working period.
+    //   PM is rising ( slope within the period, or mean compared to the previous period )
+    //       => halve the pause time, more data when it matters
+    //   stable ( low SD and slope near zero )
+    //       => pause time 1.5 times longer, to save the laser
+    //   otherwise the pause time is not changed
+    // The statistics are from the last period, as stored by _Process_Window
+    // A follower doesn't adapt, it takes the pause time of the leader
+    // ***********************************************************************
+    void _Adapt_Pause_Time () {
+      if ( ! Adaptive || ( _Last_N == 0 ) || _Following () ) {
+        return ;
+      }
+      bool Rising = ( _Last_B1 > Rising_B1 ) ||
+                    ( ( _Previous_Mean > 0 ) && ( _Last_Mean > 1.2 * _Previous_Mean + 1.0 ) ) ;
+      bool Stable = ( _Last_SD < Stable_SD ) && ( fabs ( _Last_B1 ) < Stable_B1 ) ;
+      if ( Rising ) {
+        Pause_Time_ms = Pause_Time_ms / 2 ;
+      }
+      else if ( Stable ) {
+        Pause_Time_ms = Pause_Time_ms + Pause_Time_ms / 2 ;
+      }
+      Pause_Time_ms = constrain ( Pause_Time_ms, Pause_Min_ms, Pause_Max_ms ) ;
+      _Previous_Mean = _Last_Mean ;
+    }
+
+    // ***********************************************************************
+    // A sensor with a phase follows SDS011_Phase_Leader, see Set_Phase
+    // ***********************************************************************
+    bool _Following () {
+      return ( _Phase_Offset_ms > 0 ) && ( SDS011_Phase_Leader != NULL ) && ( SDS011_Phase_Leader != this ) ;
+    }
+
+    // ***********************************************************************
+    // At the end of a working period of a follower :
+    //   the leader sleeps => wake up Offset_ms after the next wake-up of the leader
+    //   the leader works  => the same pause time as the leader ( e.g. during a burst )
+    // ***********************************************************************
+    void _Follow_Leader ( unsigned long Now ) {
+      if ( ! _Following () ) {
+        return ;
+      }
+      _Sensor_SDS011 &Leader = *SDS011_Phase_Leader ;
+      Pause_Time_ms = Leader.Pause_Time_ms ;
+      if ( Leader.Sleeping () ) {
+        unsigned long Wake = Leader._Last_Get_Data + Leader.Pause_Time_ms + _Phase_Offset_ms ;
+        if ( (long) ( Wake - Now ) > 0 ) {
+          Pause_Time_ms = Wake - Now ;
+        }
+      }
+    }
+
+    // ***********************************************************************
+    // Burst mode: during a pollution spike every sample is handed to
+    //   SDS011_Burst_Callback ( e.g. to publish it over MQTT )
+    // A burst starts when a sample is above Burst_On_PM
+    // ***********************************************************************
+    void _Burst_Sample ( unsigned long Now ) {
+      if ( ! Burst_Enable ) {
+        return ;
+      }
+      if ( ! Burst && ( 0.1 * PM_2_5 > Burst_On_PM ) && _Burst_Allowed ( Now ) ) {
+        _Start_Burst ( Now ) ;
+      }
+      if ( Burst && ( SDS011_Burst_Callback != NULL ) ) {
+        SDS011_Burst_Callback ( *this ) ;
+      }
+    }
+
+    // ***********************************************************************
+    // At the end of each working period
+    //   start a burst if the mean is above Burst_On_PM or the slope above Burst_On_B1
+    //   stop the burst if the mean is below Burst_Off_PM ( hysteresis ) and the slope
+    //     below Burst_On_B1, or after Burst_Max_ms
+    // After a burst, no new burst is started for Burst_Hold_Off_ms,
+    //   so the bandwidth stays within budget during a long episode.
+    // ***********************************************************************
+    void _Update_Burst ( unsigned long Now ) {
+      if ( ! Burst_Enable ) {
+        Burst = false ;
+        return ;
+      }
+      if ( ! Burst ) {
+        if ( ( _Last_N > 0 ) && ( ( _Last_Mean > Burst_On_PM ) || ( _Last_B1 > Burst_On_B1 ) ) && _Burst_Allowed ( Now ) ) {
+          _Start_Burst ( Now ) ;
+        }
+      }
+      else if ( ( ( Now - _Burst_Start ) > Burst_Max_ms ) ||
+                ( ( _Last_Mean < Burst_Off_PM ) && ( _Last_B1 < Burst_On_B1 ) ) ) {
+        Burst       = false ;
+        _Burst_Stop = Now ;
+        debug_out ( "SDS011 burst stopped", DEBUG_MIN_INFO, true );
+      }
+    }
+
+    void _Start_Burst ( unsigned long Now ) {
+      Burst        = true ;
+      _Burst_Start = Now ;
+      Burst_Count += 1 ;
+      debug_out ( "SDS011 burst started", DEBUG_MIN_INFO, true );
+    }
+
+    bool _Burst_Allowed ( unsigned long Now ) {
+      return ( Burst_Count == 0 ) || ( ( Now - _Burst_Stop ) > Burst_Hold_Off_ms ) ;
+    }
+
+    // ***********************************************************************
+    // Cumulative laser on-time, in seconds ( msec are kept in _Laser_On_Rest_ms )
     // ***********************************************************************
+    void _Add_Laser_On_Time ( unsigned long On_ms ) {
+      _Laser_On_Rest_ms += On_ms ;
+      Laser_On_s        += _Laser_On_Rest_ms / 1000 ;
+      _Laser_On_Rest_ms  = _Laser_On_Rest_ms % 1000 ;
+    }
 
     // ***********************************************************************
     // Print een character buffer als hex characters, if MEDIUM debug info
@@ -353,14 +944,108 @@ class _Sensor_SDS011 {
     }
 
 
+    // ***********************************************************************
+    // Queue a command transaction,
+    //   it's sent by _Transaction_Loop as soon as the previous one is finished.
+    // If the queue is full, the command is counted as failed.
+    // ***********************************************************************
+    void _Queue_Command ( const _SDS011_Command &Command ) {
+      if ( _N_Transaction >= SDS011_MAX_TRANSACTIONS ) {
+        Commands_Failed += 1 ;
+        return ;
+      }
+      _SDS011_Transaction &T = _Transaction [ ( _First_Transaction + _N_Transaction ) % SDS011_MAX_TRANSACTIONS ] ;
+      T.Command = Command ;
+      T.Retries = SDS011_RETRIES ;
+      _N_Transaction += 1 ;
+    }
+
+    void _Queue_Command_P ( const _SDS011_Command *Command ) {
+      _SDS011_Command Buffer ;
+      memcpy_P ( &Buffer, Command, sizeof ( Buffer ) ) ;
+      _Queue_Command ( Buffer ) ;
+    }
+
+    // ***********************************************************************
+    // Sends the first queued command, and repeats it if no answer
+    //   is received within the timeout of that command.
+    // ***********************************************************************
+    void _Transaction_Loop ( unsigned long Now ) {
+      if ( _N_Transaction == 0 ) {
+        return ;
+      }
+      _SDS011_Transaction &T = _Transaction [ _First_Transaction ] ;
+
+      if ( _Transaction_Sent ) {
+        // **************************************************
+        // waking up ( laser + ventilator ) takes more time
+        // **************************************************
+        unsigned long Timeout = SDS011_REPLY_TIMEOUT_MS ;
+        if ( ( T.Command.Bytes[2] == 0x06 ) && ( T.Command.Bytes[4] == 0x01 ) ) {
+          Timeout = SDS011_WAKE_TIMEOUT_MS ;
+        }
+        if ( ( Now - _Transaction_Time ) < Timeout ) {
+          return ;
+        }
+        if ( T.Retries == 0 ) {
+          sprintf ( msg, "SDS011 command %#04x failed", T.Command.Bytes[2] ) ;
+          debug_out ( msg, DEBUG_MIN_INFO, true );
+          Commands_Failed += 1 ;
+          _Next_Transaction () ;
+          return ;
+        }
+        T.Retries -= 1 ;
+      }
+      _Send_Command ( T.Command ) ;
+      _Transaction_Sent = true ;
+      _Transaction_Time = Now ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void _Next_Transaction () {
+      _First_Transaction = ( _First_Transaction + 1 ) % SDS011_MAX_TRANSACTIONS ;
+      _N_Transaction    -= 1 ;
+      _Transaction_Sent  = false ;
+    }
+
+    // ***********************************************************************
+    // Handle a C5 reply, if it belongs to the pending command
+    //   the transaction is finished.
+    // Frame = AA C5 Cmd d1 d2 d3 d4 d5 CS AB
+    // ***********************************************************************
+    void _Handle_Reply ( uint8_t *Frame ) {
+      if ( ( _N_Transaction == 0 ) || ! _Transaction_Sent ||
+           ( Frame[2] != _Transaction [ _First_Transaction ].Command.Bytes[2] ) ) {
+        debug_out ( "\nUndesired Answer", DEBUG_MAX_INFO, true );
+        return ;
+      }
+      switch ( Frame[2] ) {
+        case 0x06 :
+          Awake = ( Frame[4] == 0x01 ) ;
+          break ;
+
+        case 0x07 :
+          Device_Firmware = "20" ;
+          Device_Firmware += String ( Frame[3], 10 ) + "." ;
+          Device_Firmware += String ( Frame[4], 10 ) + "." ;
+          Device_Firmware += String ( Frame[5], 10 ) ;
+          Device_ID = 256 * Frame[6] + Frame[7] ;
+          debug_out ( Get_Version (), DEBUG_MAX_INFO, true );
+          break ;
+      }
+      Commands_OK += 1 ;
+      _Next_Transaction () ;
+    }
+
     // ***********************************************************************
     // All responses have the same length
     //   and are roughly build in the same way.
-    //   So we can use the same function for alle responses.
+    // The bytes are checked and assembled by the table driven frame parser,
+    //   a partial frame is kept until the next call.
     //
-    // Code    = comand-ID, which is reflected in third byte of the response 
-    //           (except when quering the data)
-    // Respons = the second and third byte of teh response
+    // Measurement data ( C0 ) is stored in _Data, until it's used as a sample
+    // Replies on commands ( C5 ) are handled by the transaction layer
     //
     // Code   Respons   Meaning
     //  02    C5, 02    Set the work-mode Passive = query / active
@@ -370,110 +1055,102 @@ class _Sensor_SDS011 {
     //  07    C5, 07    Get Firmware and Device-ID
     //  08    C5, 08    Set working period
     // ***********************************************************************
-    void _Get_Response (  uint8_t Cmd2 ) {
-      int    CheckSum   = 0 ;
-      int    Answer_Len = 0 ;
-    
+    void _Poll () {
+      unsigned long Now = millis () ;
       while ( _serialSDS->available () > 0 ) {
-        char kar = _serialSDS->read() ;
-        
-        // ***************************************
-        // DEBUG INFO if MAX info
-        // ***************************************
-        if ( Answer_Len > -1 ) { 
-          sprintf ( msg, "#%d %s  ", Answer_Len + 1, String ( kar, HEX ).c_str() ) ;
-          debug_out ( msg, DEBUG_MAX_INFO, false );
+        if ( ! _Parser.Feed ( _serialSDS->read () ) ) {
+          continue ;
         }
-
-        // ***************************************
-        // ***************************************
-        switch ( Answer_Len ) {
-          case 0 :
-            if ( kar == 0xAA ) {
-              Answer_Len += 1 ;
-            }
-            break ;
-    
-          case 1 :
-            if ((( Cmd2 == 0x04 ) && ( kar == 0xC0 )) || (( Cmd2 != 0x04 ) && ( kar == 0xC5 ) ) ) {
-              Answer_Len += 1 ;
-            }
-            else {
-              Answer_Len = 0 ;
-            }
-            break ;
-            
-          case 2 :
-            // *******************************************
-            // for all commands, except the data query,
-            //   the command ID is reflected in the answer
-            //   so check it
-            // Because the data is send autonomuously by the sensor
-            //    this will happen often ( so not realy an error)
-            //    thus we only give a message if MAX info
-            // *******************************************
-            if  ( ( Cmd2 != 0x04 ) && ( Cmd2 != kar )) {
-              debug_out ( "\nUndesired Answer", DEBUG_MAX_INFO, true );
-              Answer_Len = 0 ;
-              break ;
-            }
-            // ****************************************
-            // checksum is calculated over bytes 2 .. 8
-            // ****************************************
-            Answer_Len += 1 ;
-            CheckSum = kar ;
-            break;
-            
-          case 8 : 
-            if ( kar == ( CheckSum % 256 ) ) {
-              // ***************************************
-              // DEBUG INFO if MAX info
-              // ***************************************
-              debug_out ( "\nChecksum OK", DEBUG_MAX_INFO, true );
-              Answer_Len += 1 ;
-            }
-            // ********************************************
-            // Als Checksum fout, helemaal opnieuw beginnen
-            // ********************************************
-            else {
-              Answer_Len = 0 ;
-            }
-            break ;
-          
-          case 9 :
-            if ( kar == 0xAB ) {
-              _Data_Len = Answer_Len - 2 ;
-              return ;
-            }
-            else {
-              sprintf ( msg, " LAST BYTE WRONG#%d %s  ", Answer_Len + 1, String ( kar, HEX ).c_str() ) ;
-              debug_out ( msg, DEBUG_MIN_INFO, false );
-              Answer_Len = 0 ;
-            }
-            break;
-            
-          default :
-            Answer_Len += 1 ;
-            CheckSum += kar ;
+        uint8_t *Frame = _Parser.Frame ;
+        if ( Frame[1] == 0xC5 ) {
+          _Handle_Reply ( Frame ) ;
+          continue ;
         }
-        if ( Answer_Len >= 3 ) {
-              _Data [ Answer_Len - 3 ] = kar ;
-            }
-    
-        // ***************************************
-        // DEBUG INFO if MAX info
-        // ***************************************
-        if ( Answer_Len < 3 ) {
-          debug_out ( ".", DEBUG_MAX_INFO, false );
+
+        // *********************************************
+        // _Data starts at the third byte of the frame,
+        //   without the checksum and the tail
+        // *********************************************
+        int Len = _Parser.Frame_Len - 3 ;
+        if ( Outlier_Filter && ( ( Now - _Data_Time ) < SDS011_DUPLICATE_MS ) &&
+             ( memcmp ( _Data, Frame + 2, Len ) == 0 ) ) {
+          Duplicate_Frames += 1 ;
+          _Reject_Sample () ;
+          continue ;
         }
+        _Data_Len  = Len ;
+        _Data_Time = Now ;
+        memcpy ( _Data, Frame + 2, _Data_Len ) ;
       }
-      // *****************************************************
-      // No more data from sensor, and no good answer received
-      // *****************************************************
-      _Data_Len = 0 ;
     }
 
 };
 
 
-#endif
+// ***********************************************************************************
+// Numbered SDS011 sensor, for more sensors on one node ( SDS_COUNT in ext_def.h ).
+// Each number is a different type, so the sensor registry can hold them all.
+//   Sensor 0 uses SDS_PIN_RX / SDS_PIN_TX ( or the hardware UART, see SDS_SERIAL ),
+//   the others use SDS_2_PIN_xx and SDS_3_PIN_xx
+// The working periods are staggered by SDS_STAGGER_MS,
+//   so the inrush currents of the fans and lasers don't coincide.
+//   Sensor 0 is the phase leader, only its pause time is adapted ( SDS_ADAPTIVE ),
+//   the others keep their offset to it.
+// The mode and version request are queued here, they're sent from loop.
+// ***********************************************************************************
+constexpr int _SDS011_Pins [][2] = { { SDS_PIN_RX,   SDS_PIN_TX   },
+                                 { SDS_2_PIN_RX, SDS_2_PIN_TX },
+                                 { SDS_3_PIN_RX, SDS_3_PIN_TX } } ;
+
+// ***********************************************************************************
+// Pin conflicts of the extra sensors, checked at compile time
+//   ( the pins Dx are constants, not macros, so the preprocessor can't compare them )
+//   - boot strap pins D3 ( GPIO0 ), D4 ( GPIO2 ) and D8 ( GPIO15 ) can't be used
+//   - D0 ( GPIO16 ) has no interrupt, so it can't be a SoftSerial RX
+//   - the swapped UART ( SDS_SERIAL 1 ) uses D7 and D8, debug output goes to D4
+//   - the I2C sensors use D3 / D4, the DHT22 uses DHT_PIN
+// ***********************************************************************************
+#define _SDS011_USES(Index,Pin)  ( ( SDS_COUNT > Index ) && \
+                                   ( ( _SDS011_Pins [Index][0] == (Pin) ) || ( _SDS011_Pins [Index][1] == (Pin) ) ) )
+#define _SDS011_EXTRA_USES(Pin)  ( _SDS011_USES ( 1, Pin ) || _SDS011_USES ( 2, Pin ) )
+
+#if defined(ESP8266)
+static_assert ( ! _SDS011_EXTRA_USES ( D3 ) && ! _SDS011_EXTRA_USES ( D4 ) && ! _SDS011_EXTRA_USES ( D8 ),
+                "SDS011: D3, D4 and D8 are boot strap pins, select other SDS_2_PIN_xx / SDS_3_PIN_xx" ) ;
+static_assert ( ! ( ( SDS_COUNT > 1 ) && ( _SDS011_Pins [1][0] == D0 ) ) && ! ( ( SDS_COUNT > 2 ) && ( _SDS011_Pins [2][0] == D0 ) ),
+                "SDS011: D0 can't be used as SoftSerial RX" ) ;
+static_assert ( ! ( ( SDS_SERIAL == SERIAL_TRANSPORT_HARDWARE ) && ( _SDS011_EXTRA_USES ( D7 ) || _SDS011_EXTRA_USES ( D8 ) ) ),
+                "SDS011: D7 and D8 are used by the hardware UART ( SDS_SERIAL 1 ), select other pins or SDS_COUNT" ) ;
+static_assert ( ! ( DHT_READ && _SDS011_EXTRA_USES ( DHT_PIN ) ),
+                "SDS011: the DHT22 uses the same pin, set DHT_READ 0 or select other pins" ) ;
+static_assert ( ! ( DEEP_SLEEP && _SDS011_EXTRA_USES ( D0 ) ),
+                "SDS011: D0 is connected to RST for the deep sleep" ) ;
+#endif
+
+template < int Index >
+class _Sensor_SDS011_N : public _Sensor_SDS011 {
+  public:
+    _Sensor_SDS011_N () : _Sensor_SDS011 ( _SDS011_Pins [Index][0], _SDS011_Pins [Index][1],
+                                           ( Index == 0 ) && ( SDS_SERIAL == SERIAL_TRANSPORT_HARDWARE ) ) {
+      Multiple     = ( SDS_COUNT > 1 ) ;
+      Adaptive     = SDS_ADAPTIVE ;
+      Auto_Window  = SDS_AUTO_WINDOW ;
+      Outlier_Filter = SDS_OUTLIER_FILTER ;
+      Burst_Enable = SDS_BURST ;
+      Burst_On_PM  = SDS_BURST_ON_PM ;
+      Burst_Off_PM = SDS_BURST_OFF_PM ;
+      Burst_Max_ms = SDS_BURST_MAX_MS ;
+      Burst_Hold_Off_ms = SDS_BURST_HOLD_OFF_MS ;
+      Pause_Min_ms = SDS_PAUSE_MIN_MS ;
+      Pause_Max_ms = SDS_PAUSE_MAX_MS ;
+      Set_Mode        ( SDS_MODE, SDS_PERIOD_MIN ) ;
+      Request_Version () ;
+      if ( Index == 0 ) {
+        SDS011_Phase_Leader = this ;
+      }
+      Set_Phase       ( Index * (unsigned long) SDS_STAGGER_MS ) ;
+    }
+} ;
+
+
+#endif
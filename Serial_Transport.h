@@ -0,0 +1,74 @@
+// ***********************************************************************************
+// This file implements the serial ports that can be used by the sensors.
+// All ports are returned as a Stream, so the sensor class doesn't need to know
+//   which kind of port it's using.
+//
+//   Software : SoftwareSerial on any 2 pins,
+//              bit-banged, so an interrupt for every received bit
+//   Hardware : UART0, swapped to GPIO13 (D7) = RX and GPIO15 (D8) = TX,
+//              with a larger receive FIFO, no interrupt per bit.
+//              Serial can then no longer be used for debug output,
+//              so debug output goes to Serial1 ( GPIO2 = D4, TX only ), see DEBUG_SERIAL
+//
+// Any other Stream ( e.g. a simulated sensor ) can be given directly to the sensor.
+// On Linux, the host tests use a pseudo terminal as port ( test/host/Host_PTY.h ),
+//   with the simulated SDS011 on the other side.
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Serial_Transport_h
+#define _Serial_Transport_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version, SoftwareSerial and swapped UART0
+// ***********************************************************************************
+String _Serial_Transport_Version      = "0.1" ;
+String _Serial_Transport_Version_Date = "18-10-2026" ;
+String _Serial_Transport_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+
+#define SERIAL_TRANSPORT_SOFTWARE   0
+#define SERIAL_TRANSPORT_HARDWARE   1
+
+#define SERIAL_TRANSPORT_RX_BUFFER  256
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _Serial_Transport {
+
+  public:
+    // ***********************************************************************
+    // SoftwareSerial on the given pins
+    // Because Software Serial is a of abstract type Stream
+    //   We have to create it with new
+    // ***********************************************************************
+    static Stream* Software ( int RX, int TX, long Baud ) {
+      const bool Inverted = false ;
+      SoftwareSerial *Port = new SoftwareSerial ( RX, TX, Inverted, SERIAL_TRANSPORT_RX_BUFFER ) ;
+      Port -> begin ( Baud ) ;
+      return Port ;
+    }
+
+    // ***********************************************************************
+    // Hardware UART0 on the alternative pins GPIO13 / GPIO15
+    // The receive buffer must be set before begin
+    // ***********************************************************************
+    static Stream* Hardware ( long Baud ) {
+      Serial.setRxBufferSize ( SERIAL_TRANSPORT_RX_BUFFER ) ;
+      Serial.begin ( Baud ) ;
+      Serial.swap () ;
+      return &Serial ;
+    }
+} ;
+
+#endif
@@ -0,0 +1,479 @@
+// ***********************************************************************************
+// This file holds the pages of the web interface of this node,
+//   served by the web server in Web_Server.h, with the templates of html-content.h.
+//
+//   /                      root page, links to the other pages
+//   /values                the last values of the first SDS011
+//   /reset                 restart page, POST restarts the node
+//   /live                  live view of the samples, from the event stream
+//   /events                event stream ( Server-Sent Events ) of the samples and working periods
+//   /history?level=&age=&n= binary page of the history, see Web_History_Start
+//   /history.html          charts of the history, drawn in the browser
+//   /metrics               internals of the node, in the Prometheus text format
+//   /images?name=cfg_logo  logo in the footer
+//
+// The settings are compiled in ( ext_def.h, Wifi_Settings.h ),
+//   so there are no configuration pages ( yet ).
+//
+// Should be included in the main program, after the sensors are defined.
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Web_Pages_h
+#define _Web_Pages_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version, root, values and reset page
+//    - logo served as pre-compressed asset
+//    - live view with an event stream
+//    - binary history and history charts
+//    - metrics page
+// ***********************************************************************************
+String _Web_Pages_Version      = "0.1" ;
+String _Web_Pages_Version_Date = "18-10-2026" ;
+String _Web_Pages_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include "Web_Server.h"
+#include "html-history.h"
+
+const char TXT_CONTENT_TYPE_OCTET_STREAM[] PROGMEM = "application/octet-stream" ;
+const char TXT_CONTENT_TYPE_METRICS[]     PROGMEM = "text/plain; version=0.0.4" ;
+
+const char WEB_VALUES_CONTENT[] PROGMEM = "<table>\
+<tr><td>PM2.5</td><td class='r'>{pm_two}</td><td>&micro;g/m&sup3;</td></tr>\
+<tr><td>PM10</td><td class='r'>{pm_ten}</td><td>&micro;g/m&sup3;</td></tr>\
+<tr><td>Working periods</td><td class='r'>{windows}</td><td></td></tr>\
+<tr><td>Rejected samples</td><td class='r'>{rejected}</td><td></td></tr>\
+<tr><td>Laser on-time</td><td class='r'>{laser}</td><td>h</td></tr>\
+<tr><td>Signal</td><td class='r'>{signal}</td><td>dBm</td></tr>\
+<tr><td>Uptime</td><td class='r'>{uptime}</td><td>s</td></tr>\
+</table><br/><a href='/live'>Live</a><br/><a href='/history.html'>History</a>";
+
+const char WEB_LIVE_CONTENT[] PROGMEM = "<table>\
+<tr><td>PM2.5</td><td class='r' id='pm25'>-</td><td>&micro;g/m&sup3;</td></tr>\
+<tr><td>PM10</td><td class='r' id='pm10'>-</td><td>&micro;g/m&sup3;</td></tr>\
+</table><pre id='log'></pre>\
+<script>var s=new EventSource('/events');\
+s.addEventListener('sample',function(e){var d=JSON.parse(e.data);\
+document.getElementById('pm25').innerHTML=d.pm25;document.getElementById('pm10').innerHTML=d.pm10;});\
+s.addEventListener('window',function(e){document.getElementById('log').innerHTML+=e.data+'\\n';});\
+</script>";
+
+
+// ***********************************************************************************
+// The values, written in the buffer of the renderer
+// ***********************************************************************************
+void Web_Chip_ID ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%u", ESP.getChipId () ) ;
+}
+void Web_MAC ( char *Buffer, int Size ) {
+  uint8_t MAC [6] ;
+  WiFi.macAddress ( MAC ) ;
+  snprintf ( Buffer, Size, "%02X:%02X:%02X:%02X:%02X:%02X", MAC[0], MAC[1], MAC[2], MAC[3], MAC[4], MAC[5] ) ;
+}
+void Web_Firmware ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%s", Version.c_str () ) ;
+}
+void Web_Signal ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%d", WiFi.RSSI () ) ;
+}
+void Web_Uptime ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%lu", millis () / 1000 ) ;
+}
+
+#if SDS_READ
+_Sensor_SDS011 &Web_SDS () {
+  return Sensors.Get < _Sensor_SDS011_N < 0 > > () ;
+}
+void Web_PM_2_5 ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%.1f", 0.1 * Web_SDS ().PM_2_5 ) ;
+}
+void Web_PM_10 ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%.1f", 0.1 * Web_SDS ().PM_10 ) ;
+}
+void Web_Windows ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%lu", Web_SDS ().Window_Count ) ;
+}
+void Web_Rejected ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%lu", Web_SDS ().Rejected_Total ) ;
+}
+void Web_Laser ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%.1f", Web_SDS ().Laser_On_s / 3600.0 ) ;
+}
+#endif
+
+// ***********************************************************************************
+// The event stream, the events are only built if a browser is connected
+//   sample : {"id":"<prefix>","t":<millis>,"pm25":..,"pm10":..}
+//   window : {"id":"<prefix>","t":<millis>,"n":<samples>,"pm25":..,"pm10":..,"rejected":..}
+// ***********************************************************************************
+_Event_Stream Web_Events ;
+
+void Web_Stream_Sample ( _Sensor_SDS011 &Sensor ) {
+  if ( ! Web_Events.Active () ) {
+    return ;
+  }
+  char Data [ 96 ] ;
+  snprintf ( Data, sizeof ( Data ), "{\"id\":\"%s\",\"t\":%lu,\"pm25\":%.1f,\"pm10\":%.1f}",
+             Sensor.Get_JSON_Prefix ().c_str (), millis (), 0.1 * Sensor.PM_2_5, 0.1 * Sensor.PM_10 ) ;
+  Web_Events.Send ( "sample", Data ) ;
+}
+
+void Web_Stream_Window ( _Sensor_SDS011 &Sensor, int N, float PM_2_5, float PM_10 ) {
+  if ( ! Web_Events.Active () ) {
+    return ;
+  }
+  char Data [ 128 ] ;
+  snprintf ( Data, sizeof ( Data ), "{\"id\":\"%s\",\"t\":%lu,\"n\":%d,\"pm25\":%.2f,\"pm10\":%.2f,\"rejected\":%d}",
+             Sensor.Get_JSON_Prefix ().c_str (), millis (), N, PM_2_5, PM_10, Sensor.Rejected ) ;
+  Web_Events.Send ( "window", Data ) ;
+}
+
+
+// ***********************************************************************************
+// Binary page of the history, little endian :
+//   _Web_History_Head, followed by N buckets of Bucket_Size bytes as in History.h,
+//   newest first, a gap has Mean_2_5 = 0xFFFF.
+// The buckets are periodic, so there are no timestamps per bucket :
+//   end of bucket i ( seconds since boot ) = Time_s - ( Age + i ) * Period_s
+// Query : level ( 0 .. 2, default 1 ), age of the first bucket ( default 0 ), n ( default all )
+// ***********************************************************************************
+#if HISTORY
+struct _Web_History_Head {
+  uint16_t Version ;
+  uint8_t  Level ;
+  uint8_t  Bucket_Size ;
+  uint16_t N ;
+  uint16_t Age ;
+  uint32_t Period_s ;
+  uint32_t Time_s ;
+  uint32_t Now_s ;
+} ;
+static_assert ( sizeof ( _Web_History_Head ) == 20, "history head must be packed" ) ;
+
+_Web_History_Head Web_History_Head ;
+int               Web_History_Pos ;
+
+bool Web_History_Start ( const char *Query ) {
+  int Level = Web_Query_Int ( Query, "level", 1 ) ;
+  int Age   = Web_Query_Int ( Query, "age",   0 ) ;
+  int N     = Web_Query_Int ( Query, "n",     0xFFFF ) ;
+  if ( ( Level < 0 ) || ( Level >= HISTORY_LEVELS ) || ( Age < 0 ) || ( N < 0 ) ) {
+    return false ;
+  }
+  _Web_History_Head &Head = Web_History_Head ;
+  Head.Version     = 1 ;
+  Head.Level       = Level ;
+  Head.Bucket_Size = sizeof ( _History_Bucket ) ;
+  Head.Age         = min ( Age, History.Count ( Level ) ) ;
+  Head.N           = min ( N, History.Count ( Level ) - Head.Age ) ;
+  Head.Period_s    = History.Period_ms ( Level ) / 1000 ;
+  Head.Time_s      = History.Last_Time ( Level ) / 1000 ;
+  Head.Now_s       = millis () / 1000 ;
+  Web_History_Pos  = 0 ;
+  return true ;
+}
+
+// ***********************************************************************
+// The head and the buckets are copied as they are, in pieces that fit
+// ***********************************************************************
+int Web_History_Fill ( char *Out, int Size ) {
+  const int Head_Size = sizeof ( _Web_History_Head ) ;
+  const int Total     = Head_Size + Web_History_Head.N * sizeof ( _History_Bucket ) ;
+  int N = 0 ;
+  while ( ( N < Size ) && ( Web_History_Pos < Total ) ) {
+    int Len ;
+    if ( Web_History_Pos < Head_Size ) {
+      Len = min ( Size - N, Head_Size - Web_History_Pos ) ;
+      memcpy ( Out + N, (const char*) &Web_History_Head + Web_History_Pos, Len ) ;
+    }
+    else {
+      int Index  = ( Web_History_Pos - Head_Size ) / sizeof ( _History_Bucket ) ;
+      int Offset = ( Web_History_Pos - Head_Size ) % sizeof ( _History_Bucket ) ;
+      _History_Bucket Bucket ;
+      History.Get ( Web_History_Head.Level, Web_History_Head.Age + Index, Bucket ) ;
+      Len = min ( Size - N, (int) sizeof ( _History_Bucket ) - Offset ) ;
+      memcpy ( Out + N, (const char*) &Bucket + Offset, Len ) ;
+    }
+    N               += Len ;
+    Web_History_Pos += Len ;
+  }
+  return N ;
+}
+#endif
+
+
+// ***********************************************************************************
+// The metrics, see Metrics.h
+// ***********************************************************************************
+bool Metric_Uptime ( int Index, char *Buffer, int Size ) {
+  return Metric_Value ( Index, Buffer, Size, millis () / 1000 ) ;
+}
+bool Metric_Loops ( int Index, char *Buffer, int Size ) {
+  return Metric_Value ( Index, Buffer, Size, Sample_Count ) ;
+}
+bool Metric_Heap_Free ( int Index, char *Buffer, int Size ) {
+  return Metric_Value ( Index, Buffer, Size, ESP.getFreeHeap () ) ;
+}
+bool Metric_Heap_Max_Block ( int Index, char *Buffer, int Size ) {
+  return Metric_Value ( Index, Buffer, Size, ESP.getMaxFreeBlockSize () ) ;
+}
+bool Metric_RSSI ( int Index, char *Buffer, int Size ) {
+  if ( Index > 0 ) {
+    return false ;
+  }
+  snprintf ( Buffer, Size, " %d", WiFi.RSSI () ) ;
+  return true ;
+}
+bool Metric_MQTT_Connects ( int Index, char *Buffer, int Size ) {
+  return Metric_Value ( Index, Buffer, Size, MQTT_Connects ) ;
+}
+
+// ***********************************************************************
+// Per endpoint, latencies in seconds
+// ***********************************************************************
+bool Metric_Upload ( int Index, char *Buffer, int Size, int Field ) {
+  if ( Index >= UPLOAD_ENDPOINTS ) {
+    return false ;
+  }
+  _Upload_Stats &Upload = Uploads [ Index ] ;
+  switch ( Field ) {
+    case 0 : snprintf ( Buffer, Size, "{endpoint=\"%s\"} %lu",   Upload.Endpoint, Upload.Attempts ) ;        break ;
+    case 1 : snprintf ( Buffer, Size, "{endpoint=\"%s\"} %lu",   Upload.Endpoint, Upload.Failures ) ;        break ;
+    case 2 : snprintf ( Buffer, Size, "{endpoint=\"%s\"} %.3f",  Upload.Endpoint, 0.001 * Upload.Last_ms ) ; break ;
+    case 3 : snprintf ( Buffer, Size, "{endpoint=\"%s\"} %.3f",  Upload.Endpoint, 0.001 * Upload.Total_ms ) ; break ;
+  }
+  return true ;
+}
+bool Metric_Upload_Attempts ( int Index, char *Buffer, int Size ) {
+  return Metric_Upload ( Index, Buffer, Size, 0 ) ;
+}
+bool Metric_Upload_Failures ( int Index, char *Buffer, int Size ) {
+  return Metric_Upload ( Index, Buffer, Size, 1 ) ;
+}
+bool Metric_Upload_Latency ( int Index, char *Buffer, int Size ) {
+  return Metric_Upload ( Index, Buffer, Size, 2 ) ;
+}
+bool Metric_Upload_Seconds ( int Index, char *Buffer, int Size ) {
+  return Metric_Upload ( Index, Buffer, Size, 3 ) ;
+}
+
+// ***********************************************************************
+// Per SDS011
+// ***********************************************************************
+#if SDS_READ
+_Sensor_SDS011 *Metric_SDS_N ( int Index ) {
+  switch ( Index ) {
+    case 0 : return &Sensors.Get < _Sensor_SDS011_N < 0 > > () ;
+#if SDS_COUNT > 1
+    case 1 : return &Sensors.Get < _Sensor_SDS011_N < 1 > > () ;
+#endif
+#if SDS_COUNT > 2
+    case 2 : return &Sensors.Get < _Sensor_SDS011_N < 2 > > () ;
+#endif
+  }
+  return NULL ;
+}
+
+bool Metric_SDS ( int Index, char *Buffer, int Size, int Field ) {
+  _Sensor_SDS011 *Sensor = Metric_SDS_N ( Index ) ;
+  if ( Sensor == NULL ) {
+    return false ;
+  }
+  unsigned long Value = 0 ;
+  switch ( Field ) {
+    case 0 : Value = Sensor->Parser ().Frames_OK ;       break ;
+    case 1 : Value = Sensor->Parser ().Checksum_Errors ; break ;
+    case 2 : Value = Sensor->Parser ().Sync_Errors ;     break ;
+    case 3 : Value = Sensor->Duplicate_Frames ;          break ;
+    case 4 : Value = Sensor->Rejected_Total ;            break ;
+    case 5 : Value = Sensor->Window_Samples ;            break ;
+    case 6 : Value = Sensor->Window_Count ;              break ;
+  }
+  snprintf ( Buffer, Size, "{sensor=\"%d\"} %lu", Index, Value ) ;
+  return true ;
+}
+bool Metric_SDS_Frames ( int Index, char *Buffer, int Size ) {
+  return Metric_SDS ( Index, Buffer, Size, 0 ) ;
+}
+bool Metric_SDS_Checksum_Errors ( int Index, char *Buffer, int Size ) {
+  return Metric_SDS ( Index, Buffer, Size, 1 ) ;
+}
+bool Metric_SDS_Sync_Errors ( int Index, char *Buffer, int Size ) {
+  return Metric_SDS ( Index, Buffer, Size, 2 ) ;
+}
+bool Metric_SDS_Duplicates ( int Index, char *Buffer, int Size ) {
+  return Metric_SDS ( Index, Buffer, Size, 3 ) ;
+}
+bool Metric_SDS_Rejected ( int Index, char *Buffer, int Size ) {
+  return Metric_SDS ( Index, Buffer, Size, 4 ) ;
+}
+bool Metric_SDS_Window_Samples ( int Index, char *Buffer, int Size ) {
+  return Metric_SDS ( Index, Buffer, Size, 5 ) ;
+}
+bool Metric_SDS_Windows ( int Index, char *Buffer, int Size ) {
+  return Metric_SDS ( Index, Buffer, Size, 6 ) ;
+}
+#endif
+
+const _Metric Web_Metrics [] = {
+  { "fijnstof_uptime_seconds",               "gauge",   "Time since boot",                            Metric_Uptime },
+  { "fijnstof_loop_iterations_total",        "counter", "Iterations of the main loop",                Metric_Loops },
+  { "fijnstof_heap_free_bytes",              "gauge",   "Free heap",                                  Metric_Heap_Free },
+  { "fijnstof_heap_max_block_bytes",         "gauge",   "Largest free block of the heap",             Metric_Heap_Max_Block },
+  { "fijnstof_wifi_rssi_dbm",                "gauge",   "Wi-Fi signal strength",                      Metric_RSSI },
+  { "fijnstof_mqtt_connects_total",          "counter", "MQTT connections, the first one included",   Metric_MQTT_Connects },
+  { "fijnstof_upload_attempts_total",        "counter", "Uploads per endpoint",                       Metric_Upload_Attempts },
+  { "fijnstof_upload_failures_total",        "counter", "Failed uploads per endpoint",                Metric_Upload_Failures },
+  { "fijnstof_upload_latency_seconds",       "gauge",   "Duration of the last upload per endpoint",   Metric_Upload_Latency },
+  { "fijnstof_upload_seconds_total",         "counter", "Duration of all uploads per endpoint",       Metric_Upload_Seconds },
+#if SDS_READ
+  { "fijnstof_sds011_frames_total",          "counter", "Valid frames received from the SDS011",      Metric_SDS_Frames },
+  { "fijnstof_sds011_checksum_errors_total", "counter", "Frames with a wrong checksum",               Metric_SDS_Checksum_Errors },
+  { "fijnstof_sds011_sync_errors_total",     "counter", "Bytes dropped while searching a frame",      Metric_SDS_Sync_Errors },
+  { "fijnstof_sds011_duplicate_frames_total","counter", "Frames dropped as a repetition",             Metric_SDS_Duplicates },
+  { "fijnstof_sds011_rejected_samples_total","counter", "Samples rejected as outlier or stale",       Metric_SDS_Rejected },
+  { "fijnstof_sds011_window_samples",        "gauge",   "Samples in the last working period",         Metric_SDS_Window_Samples },
+  { "fijnstof_sds011_windows_total",         "counter", "Completed working periods",                  Metric_SDS_Windows },
+#endif
+  { NULL }
+} ;
+
+_Metrics_Renderer Web_Metrics_Renderer ;
+
+bool Web_Metrics_Start ( const char *Query ) {
+  Web_Metrics_Renderer.Start ( Web_Metrics ) ;
+  return true ;
+}
+
+int Web_Metrics_Fill ( char *Out, int Size ) {
+  return Web_Metrics_Renderer.Fill ( Out, Size ) ;
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+void Web_Restart () {
+  ESP.restart () ;
+}
+
+
+// ***********************************************************************************
+// The values of the header, the title differs per page
+// ***********************************************************************************
+#define WEB_HEADER_VALUES(Title) \
+  { "t",   Title }, \
+  { "tt",  "FijnStof Sensor" }, \
+  { "id",  NULL, Web_Chip_ID }, \
+  { "mac", NULL, Web_MAC }, \
+  { "fwt", "Firmware" }, \
+  { "fw",  NULL, Web_Firmware }, \
+  { "h",   "Home" }, \
+  { "n",   ( Title [0] != 0 ) ? "&raquo;" : "" }, \
+  { NULL }
+
+const _Web_Value Web_Root_Header   [] = { WEB_HEADER_VALUES ( "" ) } ;
+const _Web_Value Web_Values_Header [] = { WEB_HEADER_VALUES ( "Current values" ) } ;
+const _Web_Value Web_Reset_Header  [] = { WEB_HEADER_VALUES ( "Restart" ) } ;
+const _Web_Value Web_Live_Header   [] = { WEB_HEADER_VALUES ( "Live" ) } ;
+
+const _Web_Value Web_Footer_Values [] = {
+  { "t", "Back to home" },
+  { NULL }
+} ;
+
+const _Web_Value Web_Root_Values [] = {
+  { "t",           "Current values" },
+  { "karte",       "Map" },
+  { "conf",        "Configuration" },
+  { "conf_delete", "Delete configuration" },
+  { "restart",     "Restart" },
+  { NULL }
+} ;
+
+const _Web_Value Web_Values_Values [] = {
+#if SDS_READ
+  { "pm_two",   NULL, Web_PM_2_5 },
+  { "pm_ten",   NULL, Web_PM_10 },
+  { "windows",  NULL, Web_Windows },
+  { "rejected", NULL, Web_Rejected },
+  { "laser",    NULL, Web_Laser },
+#endif
+  { "signal",   NULL, Web_Signal },
+  { "uptime",   NULL, Web_Uptime },
+  { NULL }
+} ;
+
+const _Web_Value Web_Reset_Values [] = {
+  { "t", "Restart the sensor?" },
+  { "b", "Restart" },
+  { "c", "Cancel" },
+  { NULL }
+} ;
+
+
+// ***********************************************************************************
+// The pages
+// ***********************************************************************************
+_Web_Part Web_Root_Parts [] = {
+  { WEB_PAGE_HEADER,       Web_Root_Header },
+  { WEB_ROOT_PAGE_CONTENT, Web_Root_Values },
+  { WEB_PAGE_FOOTER,       Web_Footer_Values },
+  { NULL }
+} ;
+
+_Web_Part Web_Values_Parts [] = {
+  { WEB_PAGE_HEADER,       Web_Values_Header },
+  { WEB_VALUES_CONTENT,    Web_Values_Values },
+  { WEB_PAGE_FOOTER,       Web_Footer_Values },
+  { NULL }
+} ;
+
+_Web_Part Web_Reset_Parts [] = {
+  { WEB_PAGE_HEADER,       Web_Reset_Header },
+  { WEB_RESET_CONTENT,     Web_Reset_Values },
+  { WEB_PAGE_FOOTER,       Web_Footer_Values },
+  { NULL }
+} ;
+
+_Web_Part Web_Live_Parts [] = {
+  { WEB_PAGE_HEADER,       Web_Live_Header },
+  { WEB_LIVE_CONTENT,      NULL },
+  { WEB_PAGE_FOOTER,       Web_Footer_Values },
+  { NULL }
+} ;
+
+const _Web_Page Web_Pages [] = {
+  { "GET",  "/",                     TXT_CONTENT_TYPE_TEXT_HTML, Web_Root_Parts },
+  { "GET",  "/values",               TXT_CONTENT_TYPE_TEXT_HTML, Web_Values_Parts },
+  { "GET",  "/reset",                TXT_CONTENT_TYPE_TEXT_HTML, Web_Reset_Parts },
+  { "POST", "/reset",                TXT_CONTENT_TYPE_TEXT_HTML, Web_Root_Parts, Web_Restart },
+  { "GET",  "/live",                 TXT_CONTENT_TYPE_TEXT_HTML, Web_Live_Parts },
+  { "GET",  "/metrics",              TXT_CONTENT_TYPE_METRICS, NULL, NULL, Web_Metrics_Start, Web_Metrics_Fill },
+#if HISTORY
+  { "GET",  "/history",              TXT_CONTENT_TYPE_OCTET_STREAM, NULL, NULL, Web_History_Start, Web_History_Fill },
+#endif
+  { NULL }
+} ;
+
+// ***********************************************************************************
+// The static files, the gzip version is preferred
+// ***********************************************************************************
+const _Web_Asset Web_Assets [] = {
+  { "/images?name=cfg_logo", TXT_CONTENT_TYPE_IMAGE_SVG, CFG_LOGO_SVG_GZIP, CFG_LOGO_SVG_GZIP_LEN,    true,  "\"cfg_logo-1z\"" },
+  { "/images?name=cfg_logo", TXT_CONTENT_TYPE_IMAGE_SVG, CFG_LOGO_SVG,      sizeof ( CFG_LOGO_SVG ) - 1, false, "\"cfg_logo-1\"" },
+  { "/history.html",         TXT_CONTENT_TYPE_TEXT_HTML, WEB_HISTORY_PAGE_GZIP, WEB_HISTORY_PAGE_GZIP_LEN,    true,  "\"history-1z\"" },
+  { "/history.html",         TXT_CONTENT_TYPE_TEXT_HTML, WEB_HISTORY_PAGE,      sizeof ( WEB_HISTORY_PAGE ) - 1, false, "\"history-1\"" },
+  { NULL }
+} ;
+
+_Web_Server Web ( 80, Web_Pages, Web_Assets ) ;
+
+#endif
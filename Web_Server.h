@@ -0,0 +1,711 @@
+// ***********************************************************************************
+// This file implements a small non-blocking web server,
+//   that renders the PROGMEM templates of html-content.h.
+//
+// Each call of loop does only a small step ( accept, read what's available,
+//   or send one chunk that fits in the TCP send buffer ), so a connected browser
+//   never stalls the sampling of the sensors.
+// Only one client is handled at a time, others wait in the backlog of the server.
+//
+// A page is a list of parts, each part is a PROGMEM template with its own values.
+// The templates are streamed directly from flash, placeholders like {t}
+//   are replaced on the fly, no String copies are made.
+// The positions of the placeholders are found once, in begin.
+// A value is a constant text or a function that writes the value in a small buffer.
+//
+//   const _Web_Value Root_Values [] = { { "t", "Current values" }, { "id", NULL, Get_Chip_ID }, { NULL } } ;
+//   _Web_Part        Root_Parts  [] = { { WEB_PAGE_HEADER, Header_Values }, { WEB_ROOT_PAGE_CONTENT, Root_Values }, { NULL } } ;
+//   const _Web_Page  Pages       [] = { { "GET", "/", TXT_CONTENT_TYPE_TEXT_HTML, Root_Parts }, { NULL } } ;
+//
+// Static files ( e.g. images ) are served from a table of assets, without any processing :
+//   the bytes are sent straight from flash, pre-compressed assets with Content-Encoding gzip.
+// Each asset has an ETag, if the browser already has that version ( If-None-Match ),
+//   only a 304 Not Modified is sent. An asset can be listed twice, gzip first,
+//   then the uncompressed version for a client that doesn't accept gzip.
+//
+//   const _Web_Asset Assets [] = { { "/logo", TXT_CONTENT_TYPE_IMAGE_SVG, LOGO_GZIP, LOGO_GZIP_LEN, true, "\"logo-1\"" }, { NULL } } ;
+//
+// A dynamic page has no parts but a Fill function, that writes the body chunk by chunk
+//   ( e.g. binary data ). Its path matches with any query, the query is given to Start,
+//   if Start returns false the client gets a 400 Bad Request.
+//
+// A GET on the path of an event stream hands the connection over to that stream,
+//   see Event_Stream.h, so the web server is free for the next request.
+//
+// Public Functions implemented :
+//     _Web_Server ( uint16_t Port, const _Web_Page *Pages, const _Web_Asset *Assets = NULL ) {
+//     void begin () {
+//     void Set_Stream ( const char *Path, _Event_Stream *Stream ) {
+//     void loop () {                 // should be called in each loop
+//     bool Busy () {                 // true if a client is connected or waiting
+//     unsigned long Requests, Not_Found, Not_Modified, Timeouts
+//     int  Web_Query_Int ( const char *Query, const char *Name, int Default ) {
+//
+// As I don't like redundancy, -h and -cpp files are combined and no separate definitions are made.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Web_Server_h
+#define _Web_Server_h
+
+// ***********************************************************************************
+// ***********************************************************************************
+// Version 0.1, 18-10-2026, SM
+//    - initial version, streaming templates from PROGMEM
+//    - templates split in segments once, rendering without searching placeholders
+//    - static assets from flash, pre-compressed, with ETag
+//    - hand-over of a connection to an event stream
+//    - dynamic pages with a query
+// ***********************************************************************************
+String _Web_Server_Version      = "0.1" ;
+String _Web_Server_Version_Date = "18-10-2026" ;
+String _Web_Server_Version_By   = "SM" ;
+// ***********************************************************************************
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include "Event_Stream.h"
+#include "LuftDaten.h"
+
+#define WEB_CHUNK_SIZE       256      // maximum bytes sent in one call of loop
+#define WEB_LINE_SIZE        128      // longer request lines are truncated
+#define WEB_HEAD_SIZE        256
+#define WEB_ETAG_SIZE        24
+#define WEB_VALUE_SIZE       64
+#define WEB_NAME_SIZE        16       // maximum length of a placeholder name
+#define WEB_SEGMENTS         96       // literal runs of all templates together
+#define WEB_TIMEOUT_MS       3000
+#define WEB_ASSET_MAX_AGE    3600     // seconds the browser may use an asset without asking
+
+#define WEB_IDLE             0
+#define WEB_REQUEST          1
+#define WEB_SEND             2
+
+
+// ***********************************************************************************
+// A value for a placeholder, a constant Text or a function Get.
+// The list of values is closed by Name = NULL.
+// ***********************************************************************************
+struct _Web_Value {
+  const char *Name ;
+  const char *Text ;
+  void ( *Get ) ( char *Buffer, int Size ) ;
+} ;
+
+// ***********************************************************************************
+// A literal run of a template ( Offset, Length ), followed by the value
+//   with index Value in the values of the part ( -1 = no value, end of the template ).
+// ***********************************************************************************
+struct _Web_Segment {
+  uint16_t Offset ;
+  uint16_t Length ;
+  int8_t   Value ;
+} ;
+
+// ***********************************************************************************
+// A PROGMEM template with its values, the list of parts is closed by Template = NULL
+// Segments is filled by _Template_Renderer::Compile, at the start of the web server.
+// ***********************************************************************************
+struct _Web_Part {
+  PGM_P             Template ;
+  const _Web_Value *Values ;
+  _Web_Segment     *Segments ;
+  uint8_t           N_Segments ;
+} ;
+
+// ***********************************************************************************
+// Action is called after the page is sent ( e.g. a restart ),
+// Start and Fill are for a dynamic page, Fill returns 0 when the body is complete
+// The list of pages is closed by Path = NULL
+// ***********************************************************************************
+struct _Web_Page {
+  const char      *Method ;
+  const char      *Path ;
+  PGM_P            Content_Type ;
+  _Web_Part       *Parts ;
+  void          ( *Action ) () ;
+  bool          ( *Start  ) ( const char *Query ) ;
+  int           ( *Fill   ) ( char *Out, int Size ) ;
+} ;
+
+// ***********************************************************************************
+// The value of Name in a query like "level=1&n=60", Default if it's not there
+// ***********************************************************************************
+int Web_Query_Int ( const char *Query, const char *Name, int Default ) {
+  int Len = strlen ( Name ) ;
+  for ( const char *P = Query; *P != 0; ) {
+    if ( ( strncmp ( P, Name, Len ) == 0 ) && ( P [ Len ] == '=' ) ) {
+      return atoi ( P + Len + 1 ) ;
+    }
+    P = strchr ( P, '&' ) ;
+    if ( P == NULL ) {
+      break ;
+    }
+    P += 1 ;
+  }
+  return Default ;
+}
+
+// ***********************************************************************************
+// A static file in flash, the list of assets is closed by Path = NULL
+// The ETag should change when the data changes, it includes the quotes.
+// ***********************************************************************************
+struct _Web_Asset {
+  const char *Path ;
+  PGM_P       Content_Type ;
+  PGM_P       Data ;
+  uint32_t    Length ;
+  bool        Gzip ;
+  const char *ETag ;
+} ;
+
+
+// ***********************************************************************************
+// Streams the parts of a page, with the placeholders replaced.
+//
+// The templates are scanned only once, by Compile, which splits each template
+//   in literal runs and the index of the value that follows ( e.g. {karte} ).
+// So rendering is a straight walk over the segments : copy a run from flash,
+//   write a value, no searching for placeholders and no comparing of names.
+// If the segment pool is full, the part is sent as is, without replacements.
+//
+// Fill can be called with any buffer size, it continues where it stopped.
+// ***********************************************************************************
+class _Template_Renderer {
+
+  public:
+    // ***********************************************************************
+    // Build the segments of all parts, parts used by more pages are compiled once
+    // ***********************************************************************
+    void Compile ( _Web_Part *Parts ) {
+      for ( _Web_Part *Part = Parts; ( Part != NULL ) && ( Part->Template != NULL ); Part++ ) {
+        if ( Part->Segments == NULL ) {
+          _Compile ( Part ) ;
+        }
+      }
+    }
+
+    void Start ( const _Web_Part *Parts ) {
+      _Value_Len = 0 ;
+      _Value_Pos = 0 ;
+      _Start_Part ( Parts ) ;
+    }
+
+    // ***********************************************************************
+    // Returns the number of bytes in Out, 0 if the page is complete
+    // ***********************************************************************
+    int Fill ( char *Out, int Size ) {
+      int N = 0 ;
+      while ( N < Size ) {
+        if ( _Value_Pos < _Value_Len ) {
+          int Len = min ( _Value_Len - _Value_Pos, Size - N ) ;
+          memcpy ( Out + N, _Value_Text + _Value_Pos, Len ) ;
+          _Value_Pos += Len ;
+          N          += Len ;
+          continue ;
+        }
+        if ( ( _Part == NULL ) || ( _Part->Template == NULL ) ) {
+          break ;
+        }
+        if ( _Pos < _Segment->Length ) {
+          int Len = min ( _Segment->Length - _Pos, Size - N ) ;
+          memcpy_P ( Out + N, _Part->Template + _Segment->Offset + _Pos, Len ) ;
+          _Pos += Len ;
+          N    += Len ;
+          continue ;
+        }
+        if ( _Segment->Value >= 0 ) {
+          _Load_Value ( _Part->Values [ _Segment->Value ] ) ;
+        }
+        if ( ++_Index < _Part->N_Segments ) {
+          _Segment = &_Part->Segments [ _Index ] ;
+          _Pos     = 0 ;
+        }
+        else {
+          _Start_Part ( _Part + 1 ) ;
+        }
+      }
+      return N ;
+    }
+
+    int Segments_Used () {
+      return _N_Segments ;
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    _Web_Segment        _Segments [ WEB_SEGMENTS ] ;
+    int                 _N_Segments = 0 ;
+
+    const _Web_Part    *_Part       = NULL ;
+    const _Web_Segment *_Segment    = NULL ;
+    _Web_Segment        _Raw ;                  // a part without segments
+    int                 _Index      = 0 ;
+    int                 _Pos        = 0 ;
+    char                _Value [ WEB_VALUE_SIZE ] ;
+    const char         *_Value_Text = NULL ;
+    int                 _Value_Len  = 0 ;
+    int                 _Value_Pos  = 0 ;
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void _Start_Part ( const _Web_Part *Part ) {
+      _Part  = Part ;
+      _Index = 0 ;
+      _Pos   = 0 ;
+      if ( ( Part == NULL ) || ( Part->Template == NULL ) ) {
+        return ;
+      }
+      if ( Part->N_Segments > 0 ) {
+        _Segment = &Part->Segments [0] ;
+      }
+      else {
+        _Raw.Offset = 0 ;
+        _Raw.Length = strlen_P ( Part->Template ) ;
+        _Raw.Value  = -1 ;
+        _Segment    = &_Raw ;
+      }
+    }
+
+    // ***********************************************************************
+    // A constant text is sent directly, a function writes in the value buffer
+    // ***********************************************************************
+    void _Load_Value ( const _Web_Value &Value ) {
+      if ( Value.Get != NULL ) {
+        _Value [0] = 0 ;
+        Value.Get ( _Value, sizeof ( _Value ) ) ;
+        _Value_Text = _Value ;
+      }
+      else {
+        _Value_Text = Value.Text ;
+      }
+      _Value_Len = strlen ( _Value_Text ) ;
+      _Value_Pos = 0 ;
+    }
+
+    // ***********************************************************************
+    // Split the template at the placeholders that have a value,
+    //   the last segment holds the rest of the template and no value
+    // ***********************************************************************
+    void _Compile ( _Web_Part *Part ) {
+      _Web_Segment *First = _Segments + _N_Segments ;
+      int           N     = 0 ;
+      int           Start = 0 ;
+      int           Pos   = 0 ;
+      for ( ;; ) {
+        char C = pgm_read_byte ( Part->Template + Pos ) ;
+        int  Len ;
+        int  Value = -1 ;
+        if ( C == '{' ) {
+          Value = _Find_Value ( Part, Pos + 1, Len ) ;
+        }
+        if ( ( C != 0 ) && ( Value < 0 ) ) {
+          Pos += 1 ;
+          continue ;
+        }
+        if ( _N_Segments + N >= WEB_SEGMENTS ) {
+          debug_out ( "Web : too many template segments, increase WEB_SEGMENTS", DEBUG_ERROR, true ) ;
+          return ;
+        }
+        First [N].Offset = Start ;
+        First [N].Length = Pos - Start ;
+        First [N].Value  = Value ;
+        N += 1 ;
+        if ( C == 0 ) {
+          break ;
+        }
+        Pos  += Len + 2 ;
+        Start = Pos ;
+      }
+      Part->Segments   = First ;
+      Part->N_Segments = N ;
+      _N_Segments     += N ;
+    }
+
+    // ***********************************************************************
+    // Pos is just after a '{', if it's a placeholder of which the part has a value,
+    //   returns the index of the value and the length of the name.
+    // Otherwise ( e.g. CSS ) returns -1 and the '{' is just a character.
+    // ***********************************************************************
+    int _Find_Value ( const _Web_Part *Part, int Pos, int &Len ) {
+      char Name [ WEB_NAME_SIZE + 1 ] ;
+      Len = 0 ;
+      for ( ;; ) {
+        char C = pgm_read_byte ( Part->Template + Pos + Len ) ;
+        if ( C == '}' ) {
+          break ;
+        }
+        if ( ( Len >= WEB_NAME_SIZE ) || ! ( ( ( C >= 'a' ) && ( C <= 'z' ) ) || ( C == '_' ) ) ) {
+          return -1 ;
+        }
+        Name [ Len++ ] = C ;
+      }
+      Name [ Len ] = 0 ;
+
+      for ( int i = 0; ( Part->Values != NULL ) && ( Part->Values [i].Name != NULL ); i++ ) {
+        if ( strcmp ( Part->Values [i].Name, Name ) == 0 ) {
+          return i ;
+        }
+      }
+      return -1 ;
+    }
+} ;
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _Web_Server {
+
+  public:
+    unsigned long Requests     = 0 ;
+    unsigned long Not_Found    = 0 ;
+    unsigned long Not_Modified = 0 ;
+    unsigned long Timeouts     = 0 ;
+
+    _Web_Server ( uint16_t Port, const _Web_Page *Pages, const _Web_Asset *Assets = NULL ) : _Server ( Port ) {
+      _Pages  = Pages ;
+      _Assets = Assets ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void begin () {
+      for ( const _Web_Page *Page = _Pages; Page->Path != NULL; Page++ ) {
+        _Renderer.Compile ( Page->Parts ) ;
+      }
+      _Server.begin () ;
+      _Server.setNoDelay ( true ) ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void Set_Stream ( const char *Path, _Event_Stream *Stream ) {
+      _Stream_Path = Path ;
+      _Stream      = Stream ;
+    }
+
+    // ***********************************************************************
+    // true if a client is connected or waiting, then loop should be called soon
+    // ***********************************************************************
+    bool Busy () {
+      return ( _State != WEB_IDLE ) || _Server.hasClient () ;
+    }
+
+    // ***********************************************************************
+    // Does one small step, never waits for the client
+    // ***********************************************************************
+    void loop () {
+      switch ( _State ) {
+        case WEB_IDLE :
+          if ( _Server.hasClient () ) {
+            _Client    = _Server.available () ;
+            _Start     = millis () ;
+            _Line_Len  = 0 ;
+            _N_Lines   = 0 ;
+            _Page      = NULL ;
+            _Asset     = NULL ;
+            _To_Stream = false ;
+            _Page_OK   = true ;
+            _Gzip_OK   = false ;
+            _ETag [0]  = 0 ;
+            _State     = WEB_REQUEST ;
+          }
+          break ;
+
+        case WEB_REQUEST :
+          _Read_Request () ;
+          break ;
+
+        case WEB_SEND :
+          _Send () ;
+          break ;
+      }
+      if ( ( _State != WEB_IDLE ) && ( ( millis () - _Start ) > WEB_TIMEOUT_MS ) ) {
+        Timeouts += 1 ;
+        _Close () ;
+      }
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    WiFiServer         _Server ;
+    WiFiClient         _Client ;
+    const _Web_Page   *_Pages ;
+    const _Web_Page   *_Page     = NULL ;
+    const _Web_Asset  *_Assets ;
+    const _Web_Asset  *_Asset    = NULL ;
+    const char        *_Stream_Path ;
+    _Event_Stream     *_Stream   = NULL ;
+    bool               _To_Stream = false ;      // the request is for the event stream
+    bool               _Page_OK  = true ;        // Start of a dynamic page accepted the query
+    uint32_t           _Body_Len = 0 ;
+    uint32_t           _Body_Pos = 0 ;
+    bool               _Gzip_OK  = false ;
+    char               _ETag [ WEB_ETAG_SIZE ] ;      // If-None-Match of the request
+    int                _State    = WEB_IDLE ;
+    unsigned long      _Start    = 0 ;
+    char               _Line [ WEB_LINE_SIZE ] ;
+    int                _Line_Len = 0 ;
+    int                _N_Lines  = 0 ;
+    char               _Head [ WEB_HEAD_SIZE ] ;
+    int                _Head_Len = 0 ;
+    int                _Head_Pos = 0 ;
+    char               _Chunk [ WEB_CHUNK_SIZE ] ;
+    _Template_Renderer _Renderer ;
+
+    // ***********************************************************************
+    // Read the available bytes of the request, line by line,
+    //   as soon as the empty line after the headers is received, start sending
+    // ***********************************************************************
+    void _Read_Request () {
+      while ( _Client.available () > 0 ) {
+        char C = _Client.read () ;
+        if ( C == '\r' ) {
+          continue ;
+        }
+        if ( C != '\n' ) {
+          if ( _Line_Len < WEB_LINE_SIZE - 1 ) {
+            _Line [ _Line_Len++ ] = C ;
+          }
+          continue ;
+        }
+        _Line [ _Line_Len ] = 0 ;
+        if ( _Line_Len == 0 ) {
+          _Start_Response () ;
+          return ;
+        }
+        if ( _N_Lines == 0 ) {
+          _Select_Page () ;
+        }
+        else {
+          _Header () ;
+        }
+        _N_Lines += 1 ;
+        _Line_Len = 0 ;
+      }
+      if ( ! _Client.connected () ) {
+        _Close () ;
+      }
+    }
+
+    // ***********************************************************************
+    // Request line :  METHOD PATH HTTP/1.1
+    // ***********************************************************************
+    void _Select_Page () {
+      char *Path = strchr ( _Line, ' ' ) ;
+      if ( Path == NULL ) {
+        return ;
+      }
+      *Path++ = 0 ;
+      char *End = strchr ( Path, ' ' ) ;
+      if ( End != NULL ) {
+        *End = 0 ;
+      }
+      for ( const _Web_Page *Page = _Pages; Page->Path != NULL; Page++ ) {
+        if ( strcmp ( Page->Method, _Line ) != 0 ) {
+          continue ;
+        }
+        if ( Page->Fill == NULL ) {
+          if ( strcmp ( Page->Path, Path ) == 0 ) {
+            _Page = Page ;
+            return ;
+          }
+          continue ;
+        }
+        // dynamic page, with or without a query
+        int Len = strlen ( Page->Path ) ;
+        if ( ( strncmp ( Page->Path, Path, Len ) == 0 ) && ( ( Path [ Len ] == 0 ) || ( Path [ Len ] == '?' ) ) ) {
+          _Page    = Page ;
+          _Page_OK = ( Page->Start == NULL ) || Page->Start ( ( Path [ Len ] == '?' ) ? Path + Len + 1 : "" ) ;
+          return ;
+        }
+      }
+      if ( strcmp ( _Line, "GET" ) != 0 ) {
+        return ;
+      }
+      if ( ( _Stream != NULL ) && ( strcmp ( _Stream_Path, Path ) == 0 ) ) {
+        _To_Stream = true ;
+        return ;
+      }
+      if ( _Assets == NULL ) {
+        return ;
+      }
+      for ( const _Web_Asset *Asset = _Assets; Asset->Path != NULL; Asset++ ) {
+        if ( strcmp ( Asset->Path, Path ) == 0 ) {
+          _Asset = Asset ;
+          return ;
+        }
+      }
+    }
+
+    // ***********************************************************************
+    // Only the headers needed for the assets are used
+    // ***********************************************************************
+    void _Header () {
+      if ( strncasecmp ( _Line, "If-None-Match:", 14 ) == 0 ) {
+        const char *Value = _Line + 14 ;
+        while ( *Value == ' ' ) {
+          Value++ ;
+        }
+        strncpy ( _ETag, Value, sizeof ( _ETag ) - 1 ) ;
+        _ETag [ sizeof ( _ETag ) - 1 ] = 0 ;
+      }
+      else if ( strncasecmp ( _Line, "Accept-Encoding:", 16 ) == 0 ) {
+        _Gzip_OK = ( strstr ( _Line + 16, "gzip" ) != NULL ) ;
+      }
+    }
+
+    // ***********************************************************************
+    // The first asset with the requested path that the client accepts
+    // ***********************************************************************
+    const _Web_Asset *_Select_Asset () {
+      const char *Path = _Asset->Path ;
+      for ( const _Web_Asset *Asset = _Asset; Asset->Path != NULL; Asset++ ) {
+        if ( ( strcmp ( Asset->Path, Path ) == 0 ) && ( _Gzip_OK || ! Asset->Gzip ) ) {
+          return Asset ;
+        }
+      }
+      return NULL ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void _Start_Response () {
+      Requests += 1 ;
+      if ( _To_Stream ) {
+        _Hand_Over () ;
+        return ;
+      }
+      _Body_Len = 0 ;
+      _Body_Pos = 0 ;
+      if ( _Asset != NULL ) {
+        _Asset = _Select_Asset () ;
+      }
+      if ( _Asset != NULL ) {
+        _Start_Asset () ;
+      }
+      else if ( ( _Page != NULL ) && ! _Page_OK ) {
+        _Page     = NULL ;
+        _Head_Len = snprintf ( _Head, sizeof ( _Head ),
+                               "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\nBad request\r\n" ) ;
+        _Renderer.Start ( NULL ) ;
+      }
+      else if ( _Page == NULL ) {
+        Not_Found += 1 ;
+        _Head_Len = snprintf ( _Head, sizeof ( _Head ),
+                               "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\nNot found\r\n" ) ;
+        _Renderer.Start ( NULL ) ;
+      }
+      else {
+        _Head_Len  = snprintf ( _Head, sizeof ( _Head ), "HTTP/1.1 200 OK\r\nContent-Type: " ) ;
+        _Head_Len += _Copy_P ( _Head + _Head_Len, _Page->Content_Type, sizeof ( _Head ) - _Head_Len ) ;
+        _Head_Len += snprintf ( _Head + _Head_Len, sizeof ( _Head ) - _Head_Len, "\r\nConnection: close\r\n\r\n" ) ;
+        _Renderer.Start ( _Page->Parts ) ;
+      }
+      _Head_Pos = 0 ;
+      _State    = WEB_SEND ;
+    }
+
+    // ***********************************************************************
+    // The stream takes over the connection, it's not closed here.
+    // If the stream has no free slot, the client gets a 503.
+    // ***********************************************************************
+    void _Hand_Over () {
+      if ( _Stream->Attach ( _Client ) ) {
+        _Client = WiFiClient () ;
+        _State  = WEB_IDLE ;
+        return ;
+      }
+      _Head_Len = snprintf ( _Head, sizeof ( _Head ),
+                             "HTTP/1.1 503 Service Unavailable\r\nContent-Type: text/plain\r\nConnection: close\r\n\r\nToo many streams\r\n" ) ;
+      _Head_Pos = 0 ;
+      _Body_Len = 0 ;
+      _Renderer.Start ( NULL ) ;
+      _State    = WEB_SEND ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void _Start_Asset () {
+      _Renderer.Start ( NULL ) ;
+      if ( strcmp ( _ETag, _Asset->ETag ) == 0 ) {
+        Not_Modified += 1 ;
+        _Head_Len = snprintf ( _Head, sizeof ( _Head ),
+                               "HTTP/1.1 304 Not Modified\r\nETag: %s\r\nConnection: close\r\n\r\n", _Asset->ETag ) ;
+        return ;
+      }
+      _Head_Len  = snprintf ( _Head, sizeof ( _Head ), "HTTP/1.1 200 OK\r\nContent-Type: " ) ;
+      _Head_Len += _Copy_P ( _Head + _Head_Len, _Asset->Content_Type, sizeof ( _Head ) - _Head_Len ) ;
+      _Head_Len += snprintf ( _Head + _Head_Len, sizeof ( _Head ) - _Head_Len,
+                              "\r\nContent-Length: %lu\r\n%sETag: %s\r\nCache-Control: max-age=%d\r\nConnection: close\r\n\r\n",
+                              (unsigned long) _Asset->Length, _Asset->Gzip ? "Content-Encoding: gzip\r\n" : "",
+                              _Asset->ETag, WEB_ASSET_MAX_AGE ) ;
+      _Body_Len = _Asset->Length ;
+    }
+
+    // ***********************************************************************
+    // Copy a PROGMEM string, returns the number of copied bytes
+    // ***********************************************************************
+    int _Copy_P ( char *Buffer, PGM_P Text, int Size ) {
+      strncpy_P ( Buffer, Text, Size - 1 ) ;
+      Buffer [ Size - 1 ] = 0 ;
+      return strlen ( Buffer ) ;
+    }
+
+    // ***********************************************************************
+    // Send at most one chunk, only as much as fits in the TCP send buffer
+    // ***********************************************************************
+    void _Send () {
+      if ( ! _Client.connected () ) {
+        _Close () ;
+        return ;
+      }
+      int Room = min ( _Client.availableForWrite (), WEB_CHUNK_SIZE ) ;
+      if ( Room <= 0 ) {
+        return ;
+      }
+      int N = 0 ;
+      while ( ( _Head_Pos < _Head_Len ) && ( N < Room ) ) {
+        _Chunk [ N++ ] = _Head [ _Head_Pos++ ] ;
+      }
+      if ( ( _Page != NULL ) && ( _Page->Fill != NULL ) ) {
+        N += _Page->Fill ( _Chunk + N, Room - N ) ;
+      }
+      else {
+        N += _Renderer.Fill ( _Chunk + N, Room - N ) ;
+      }
+      if ( ( N == 0 ) && ( _Body_Pos < _Body_Len ) ) {
+        // asset, directly from flash
+        int Len = min ( _Body_Len - _Body_Pos, (uint32_t) Room ) ;
+        _Client.write_P ( _Asset->Data + _Body_Pos, Len ) ;
+        _Body_Pos += Len ;
+        _Start     = millis () ;
+        return ;
+      }
+      if ( N == 0 ) {
+        const _Web_Page *Page = _Page ;
+        _Close () ;
+        if ( ( Page != NULL ) && ( Page->Action != NULL ) ) {
+          Page->Action () ;
+        }
+        return ;
+      }
+      _Client.write ( (const uint8_t*) _Chunk, N ) ;
+      _Start = millis () ;
+    }
+
+    // ***********************************************************************
+    // ***********************************************************************
+    void _Close () {
+      _Client.stop () ;
+      _State = WEB_IDLE ;
+    }
+} ;
+
+#endif
@@ -9,6 +9,18 @@ const char* Wifi_Pwd    = "" ;
 const char* Broker_IP   = "" ;
 int         Broker_Port = ;
 
+// Fallback brokers, tried in this order when the broker above is down
+// ( entries with an empty IP are skipped )
+const char* Broker_Fallback_IP   [] = { "" } ;
+int         Broker_Fallback_Port [] = { 1883 } ;
+
+// MQTT-SN gateway ( only used if SEND2MQTTSN ),
+// the topic-ID must be pre-defined in the gateway for the output topic,
+// topic-ID + 1 for the burst topic
+const char* MQTTSN_Gateway_IP   = "" ;
+int         MQTTSN_Gateway_Port = 1884 ;
+uint16_t    MQTTSN_Topic_ID     = 1 ;
+
 const char* MQTT_User   = "" ;
 const char* MQTT_Pwd    = "" ;
-
+
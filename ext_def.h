@@ -16,6 +16,7 @@
 #define SEND2MADAVI 1
 #define SEND2SENSEMAP 0
 #define SEND2MQTT 0
+#define SEND2MQTTSN 0
 #define SEND2INFLUX 0
 #define SEND2LORA 0
 #define SEND2CSV 0
@@ -82,6 +83,79 @@
 #define SDS_PIN_RX D1
 #define SDS_PIN_TX D2
 #endif
+// Number of SDS011 sensors ( 1 .. 3 ), the extra sensors use SoftSerial on these pins
+// the third sensor shares D7 with the DHT22 and the swapped UART ( SDS_SERIAL 1 ),
+// and D0 with the deep sleep wake-up, the conflicts are checked in Sensor_SDS011.h
+// ( D3, D4 and D8 are boot strap pins, D0 can't be used as SoftSerial RX )
+#define SDS_COUNT 1
+#if defined(ESP8266)
+#define SDS_2_PIN_RX D5
+#define SDS_2_PIN_TX D6
+#define SDS_3_PIN_RX D7
+#define SDS_3_PIN_TX D0
+#endif
+// Delay between the working periods of the SDS011 sensors, in msec
+// ( the others follow the first sensor, also when its pause time is adapted )
+#define SDS_STAGGER_MS 25000
+// SDS011 adaptive duty cycle: the pause time is made longer while PM is stable
+// and shorter while PM is rising, within these limits ( msec )
+#define SDS_ADAPTIVE 0
+#define SDS_PAUSE_MIN_MS 60000
+#define SDS_PAUSE_MAX_MS 900000
+// SDS011 automatic working period: warm-up ends when the signal is steady,
+// the working period ends as soon as the mean is accurate enough
+#define SDS_AUTO_WINDOW 0
+// SDS011 outlier rejection ( Hampel filter ) and duplicate frame detection
+// off by default, because it changes the published PM values
+#define SDS_OUTLIER_FILTER 0
+// on-device history of the first SDS011 ( 1 second / 1 minute / 1 hour ), about 3.4 kB RAM
+// can be read over MQTT, publish "history,<level>,<age>,<n>" to the input topic
+#define HISTORY 0
+// deep sleep during the pause of the SDS011, the state is kept in RTC memory
+// GPIO16 ( D0 ) must be connected to RST, only for 1 SDS011, not in working period mode
+// the currents are only used to print the energy budget
+#define DEEP_SLEEP 0
+#define DEEP_SLEEP_AWAKE_MA 80
+#define DEEP_SLEEP_SLEEP_MA 0.02
+// radio duty cycling: Wi-Fi is switched off while sampling, and only switched on
+// for RADIO_WINDOW_MS for each upload ( and during a burst )
+#define RADIO_DUTY_CYCLE 0
+#define RADIO_WINDOW_MS 5000
+// idle the main loop until the next deadline of the sensors, uploads and MQTT
+// light sleep of the modem while idle, better with the hardware UART ( SDS_SERIAL 1 )
+// IDLE_MAX_MS is the longest idle time, also the limit of Next_Event_ms of the sensors
+// the currents are only used to estimate the mean current
+// off by default, it changes the cadence of the main loop
+#define IDLE 0
+#define IDLE_LIGHT_SLEEP 0
+#define IDLE_MAX_MS 10000
+#define IDLE_STEP_MS 10
+#define IDLE_ACTIVE_MA 70
+#define IDLE_SLEEP_MA 15
+// non-blocking web interface on port 80, not available during deep sleep
+// or while the radio is off ( RADIO_DUTY_CYCLE )
+// off by default, it opens a TCP listener on every node
+#define WEB_SERVER 0
+// latency histograms of the stages of the main loop ( p50 / p99 / max ), see Loop_Timing.h
+// publish "timing" to the input topic, or type 't' on the serial port
+// ( with SDS_SERIAL 1 the debug port Serial1 can't receive, only "timing" over MQTT works )
+#define LOOP_TIMING 0
+// SDS011 burst mode: during a pollution spike the sensor stays awake and every sample
+// is published over MQTT, starts above SDS_BURST_ON_PM, stops below SDS_BURST_OFF_PM
+// a burst lasts at most SDS_BURST_MAX_MS, the next one starts at least SDS_BURST_HOLD_OFF_MS later
+#define SDS_BURST 0
+#define SDS_BURST_ON_PM 50
+#define SDS_BURST_OFF_PM 35
+#define SDS_BURST_MAX_MS 600000
+#define SDS_BURST_HOLD_OFF_MS 600000
+// SDS011 serial port: 0 = SoftwareSerial on SDS_PIN_RX / SDS_PIN_TX
+//                     1 = hardware UART0, swapped to D7 (RX) / D8 (TX),
+//                         debug output then goes to Serial1 ( D4, TX only )
+#define SDS_SERIAL 0
+// SDS011 driver mode: 0 = active reporting, 1 = query mode, 2 = working period of the sensor itself
+#define SDS_MODE 0
+// SDS011 working period in minutes ( 1 .. 30 ), only used for SDS_MODE 2
+#define SDS_PERIOD_MIN 5
 
 // PMS3003
 #define PMS24_READ 0
@@ -151,6 +225,13 @@
 // Wieviele Informationen sollen über die serielle Schnittstelle ausgegeben werden?
 #define DEBUG 3
 
+// Serial port for debug output
+#if SDS_SERIAL == 1
+#define DEBUG_SERIAL Serial1
+#else
+#define DEBUG_SERIAL Serial
+#endif
+
 // Definition der Debuglevel
 #define DEBUG_ERROR 1
 #define DEBUG_WARNING 2
@@ -182,4 +263,4 @@
 #define RF69_FREQ 868.0
 #define CLIENT_ADDRESS 2
 #define SERVER_ADDRESS 100
-#endif
+#endif
@@ -0,0 +1,111 @@
+// ***********************************************************************************
+// The history page, drawn in the browser from the binary /history data ( Web_Pages.h ).
+//
+// WEB_HISTORY_PAGE_GZIP is WEB_HISTORY_PAGE compressed with gzip -9,
+//   after a change of the page, create it again from the text of the page, e.g. with :
+//     gzip -9 -n -c history.html | xxd -i
+// ***********************************************************************************
+const char WEB_HISTORY_PAGE[] PROGMEM = "<!DOCTYPE html><html><head><title>History</title><meta name='viewport' content='width=device-width'>\
+<style>body{font-family:Arial;margin:10px}canvas{width:100%;border:1px solid #ccc}button{margin:2px;padding:5px}</style></head>\
+<body><h3>PM history</h3>\
+<button onclick='load(0)'>Seconds</button><button onclick='load(1)'>Minutes</button><button onclick='load(2)'>Hours</button>\
+<canvas id='c' width='800' height='320'></canvas><div id='i'></div>\
+<script>\
+function load(l){fetch('/history?level='+l+'&age=0&n=240').then(function(r){return r.arrayBuffer();}).then(function(b){draw(new DataView(b));});}\
+function draw(v){\
+var n=v.getUint16(4,true),s=v.getUint8(3),p=v.getUint32(8,true),c=document.getElementById('c'),x=c.getContext('2d'),w=c.width,h=c.height,m=100,d=[],i,k;\
+for(i=0;i<n;i++){var o=20+s*i,a=[];for(k=0;k<6;k++)a.push(v.getUint16(o+2*k,true));d.push(a[0]==65535?null:a);if(a[0]!=65535)m=Math.max(m,a[2],a[5]);}\
+x.clearRect(0,0,w,h);x.fillStyle='#888';x.fillText((m/10).toFixed(0)+' ug/m3',2,10);\
+function X(i){return w-(i+0.5)*w/n;}function Y(y){return h-y*(h-12)/m;}\
+function band(j,col){x.fillStyle=col;for(i=0;i<n;i++)if(d[i])x.fillRect(X(i)-w/n/2,Y(d[i][j+2]),w/n,Y(d[i][j+1])-Y(d[i][j+2])+1);}\
+function line(j,col){x.strokeStyle=col;x.beginPath();var u=false;for(i=0;i<n;i++){if(!d[i]){u=false;continue;}if(u)x.lineTo(X(i),Y(d[i][j]));else x.moveTo(X(i),Y(d[i][j]));u=true;}x.stroke();}\
+band(3,'rgba(230,130,30,0.2)');band(0,'rgba(56,181,173,0.3)');line(3,'#e6821e');line(0,'#38b5ad');\
+document.getElementById('i').innerHTML=n+' x '+p+' s, <span style=\"color:#38b5ad\">PM2.5</span> <span style=\"color:#e6821e\">PM10</span>, mean and min/max';}\
+load(1);\
+</script></body></html>\
+";
+
+const unsigned int WEB_HISTORY_PAGE_GZIP_LEN = 951;
+
+const char WEB_HISTORY_PAGE_GZIP[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x95,
+  0x6b, 0x8f, 0xe2, 0x36, 0x14, 0x86, 0xff, 0x4a, 0x66, 0x47, 0x5d, 0x3b,
+  0x13, 0x93, 0xeb, 0x42, 0x11, 0x89, 0x59, 0x75, 0x2f, 0xd5, 0x54, 0xea,
+  0xa8, 0xa3, 0xee, 0xb4, 0xea, 0x08, 0xf1, 0xc1, 0xc4, 0x86, 0x78, 0x49,
+  0x9c, 0xc8, 0x71, 0x20, 0x08, 0xf1, 0xdf, 0x7b, 0x92, 0x30, 0x03, 0xea,
+  0xee, 0xaa, 0x12, 0x84, 0xf8, 0x9c, 0xc7, 0xf1, 0x7b, 0x2e, 0x39, 0x24,
+  0x37, 0x9f, 0xfe, 0xf8, 0xf8, 0xf4, 0xfc, 0xf8, 0xd9, 0xca, 0x4c, 0x91,
+  0xcf, 0x93, 0xf3, 0x55, 0x30, 0x3e, 0x4f, 0x8c, 0x34, 0xb9, 0x98, 0xdf,
+  0xcb, 0xda, 0x94, 0xfa, 0x90, 0x78, 0xc3, 0x32, 0x29, 0x84, 0x61, 0x96,
+  0x62, 0x85, 0xa0, 0x68, 0x27, 0xc5, 0xbe, 0x2a, 0xb5, 0x41, 0x56, 0x5a,
+  0x2a, 0x23, 0x94, 0xa1, 0x68, 0x2f, 0xb9, 0xc9, 0x28, 0x17, 0x3b, 0x99,
+  0x8a, 0x51, 0xbf, 0x40, 0xf3, 0xa4, 0x36, 0x07, 0xd8, 0xb9, 0x2a, 0xf9,
+  0xe1, 0xb8, 0x06, 0x70, 0xb4, 0x66, 0x85, 0xcc, 0x0f, 0xb3, 0x5f, 0xb4,
+  0x64, 0x79, 0x5c, 0x30, 0xbd, 0x91, 0x6a, 0x16, 0xf8, 0x55, 0x7b, 0x4a,
+  0x99, 0xda, 0xb1, 0xfa, 0xd8, 0xef, 0x03, 0x8b, 0xff, 0x53, 0xbc, 0x2a,
+  0x35, 0x17, 0x7a, 0x16, 0x54, 0xad, 0x55, 0x97, 0xb9, 0xe4, 0xd6, 0x6d,
+  0x9a, 0xa6, 0xa7, 0x55, 0x63, 0x4c, 0xa9, 0x8e, 0xe7, 0xad, 0x61, 0xd5,
+  0xc6, 0x15, 0xe3, 0x5c, 0xaa, 0xcd, 0x6c, 0x0c, 0x4f, 0x49, 0xbc, 0xe1,
+  0xc0, 0xc4, 0x1b, 0xe2, 0xe8, 0x0e, 0x86, 0x98, 0xa2, 0xf9, 0xe3, 0x83,
+  0x95, 0xbd, 0x44, 0x03, 0xcb, 0x64, 0x78, 0x8c, 0x55, 0xaa, 0x34, 0x97,
+  0xe9, 0x96, 0xa2, 0xbc, 0x64, 0x1c, 0xfb, 0x36, 0x9a, 0x7f, 0x11, 0x10,
+  0x10, 0xaf, 0x13, 0x6f, 0x20, 0x7e, 0x40, 0x06, 0x40, 0x3e, 0x48, 0xd5,
+  0x18, 0xf1, 0x7f, 0x64, 0x08, 0xe4, 0x7d, 0xd9, 0xe8, 0x2b, 0x6e, 0x08,
+  0xd5, 0x92, 0x9c, 0xa2, 0x14, 0x59, 0x43, 0xda, 0xd0, 0xd4, 0xf7, 0x91,
+  0x95, 0x09, 0xb9, 0xc9, 0x20, 0x95, 0x51, 0xe8, 0x43, 0xee, 0xbc, 0x01,
+  0x9c, 0x27, 0x5c, 0xee, 0x7a, 0x5a, 0x76, 0x46, 0x58, 0x40, 0x5a, 0x53,
+  0x2d, 0x2b, 0x33, 0x5f, 0x37, 0x2a, 0x35, 0x12, 0xce, 0xec, 0x8f, 0xca,
+  0xed, 0xe3, 0x5a, 0x98, 0x34, 0xc3, 0xc8, 0x3b, 0xc7, 0xfa, 0x3e, 0x17,
+  0x3b, 0x91, 0x53, 0xe4, 0xe4, 0x0e, 0x7a, 0xcb, 0x36, 0x82, 0xfa, 0x6f,
+  0x15, 0x0d, 0xdf, 0xf9, 0xc8, 0x76, 0x4d, 0x26, 0x14, 0x7e, 0xd9, 0x8f,
+  0xb5, 0x7d, 0xd4, 0xc2, 0x34, 0x5a, 0x59, 0xda, 0x65, 0x5a, 0xb3, 0xc3,
+  0x87, 0x66, 0xbd, 0x16, 0x1a, 0xdb, 0xf1, 0xe9, 0xbf, 0xe8, 0xca, 0x3e,
+  0x72, 0xcd, 0xf6, 0x58, 0x89, 0xbd, 0xf5, 0x89, 0x19, 0xf6, 0x37, 0x74,
+  0x02, 0x18, 0x3b, 0x32, 0x3e, 0xbd, 0x0a, 0xea, 0x91, 0x9d, 0x7d, 0xdc,
+  0x31, 0x6d, 0x29, 0xba, 0x73, 0x37, 0xc2, 0xfc, 0x25, 0x95, 0x09, 0x26,
+  0xf8, 0x1d, 0x31, 0xba, 0x11, 0x36, 0xa9, 0x2f, 0xd6, 0x29, 0x8e, 0x6c,
+  0x52, 0x5d, 0xd6, 0x51, 0x88, 0xa7, 0x67, 0x2a, 0xa5, 0xbc, 0x4c, 0x9b,
+  0x02, 0x1a, 0xac, 0x73, 0x7e, 0xce, 0x45, 0x77, 0xfb, 0xe1, 0xf0, 0x1b,
+  0xc7, 0x90, 0x3b, 0x9b, 0xb4, 0x34, 0xed, 0xec, 0x1f, 0xbb, 0x1e, 0x6c,
+  0x0d, 0x46, 0x21, 0x07, 0xe3, 0x1e, 0x8c, 0x7d, 0x56, 0x49, 0x06, 0x77,
+  0x43, 0x4e, 0x49, 0x41, 0xa1, 0xa9, 0x08, 0xa7, 0x8b, 0x25, 0x91, 0x64,
+  0x1b, 0xaf, 0x4b, 0x8d, 0x25, 0xf5, 0x63, 0x99, 0xa8, 0x58, 0x3a, 0xce,
+  0x20, 0xb4, 0xa4, 0xa1, 0xef, 0xd4, 0x77, 0x92, 0x30, 0xc0, 0x7a, 0x64,
+  0x0b, 0xc8, 0x36, 0x99, 0xc4, 0x5b, 0x40, 0x98, 0x5b, 0x35, 0x75, 0x86,
+  0xaf, 0x63, 0x29, 0x9d, 0xf0, 0x6e, 0x3b, 0x28, 0xb5, 0x63, 0x3e, 0xf8,
+  0xd9, 0xc2, 0x5f, 0x52, 0x3a, 0x19, 0x8f, 0xa3, 0xf1, 0x7b, 0xd5, 0xe4,
+  0xf9, 0x8c, 0xd9, 0xb1, 0x5c, 0xf7, 0xe6, 0x9b, 0xc1, 0x6c, 0x17, 0xf4,
+  0x81, 0x99, 0xcc, 0x2d, 0x58, 0x8b, 0x0b, 0xc2, 0x16, 0xe1, 0x12, 0x2e,
+  0xe3, 0x25, 0xa4, 0xaf, 0x75, 0xd3, 0x5c, 0x30, 0xfd, 0xa7, 0x48, 0x0d,
+  0xf6, 0x89, 0x4f, 0xf6, 0x24, 0xb3, 0xe3, 0xd6, 0x5d, 0xcb, 0x3c, 0xff,
+  0xd2, 0xf5, 0x35, 0x45, 0xb7, 0xd3, 0xe9, 0x14, 0x9d, 0x4d, 0x4f, 0x5d,
+  0xc8, 0xb8, 0xf0, 0x02, 0x1f, 0x6a, 0x54, 0xfe, 0x2a, 0x5b, 0xd1, 0xb5,
+  0xb0, 0x83, 0xac, 0x66, 0xe3, 0x15, 0x11, 0x22, 0x21, 0x01, 0x4f, 0xfc,
+  0x5a, 0x92, 0x7f, 0xb0, 0x7c, 0xad, 0xf2, 0x7e, 0x84, 0xa5, 0xe3, 0xbb,
+  0x63, 0xfb, 0x6e, 0xef, 0xa9, 0xab, 0xb2, 0x3d, 0xe3, 0xc3, 0x2b, 0x93,
+  0x8d, 0x0e, 0x77, 0x38, 0x1b, 0x05, 0xa1, 0xed, 0x15, 0x57, 0xc8, 0x8a,
+  0x29, 0x8e, 0xbf, 0x92, 0xb4, 0x84, 0x76, 0xbb, 0x96, 0x06, 0x86, 0x6f,
+  0xb2, 0x0a, 0x71, 0xf3, 0x85, 0x5c, 0xda, 0x03, 0xd7, 0x87, 0xd5, 0xa9,
+  0x18, 0xc1, 0xa1, 0x5e, 0x48, 0x9e, 0x7b, 0xe7, 0xe2, 0xab, 0x13, 0x2e,
+  0xa1, 0x68, 0x9e, 0xba, 0x18, 0x82, 0xa5, 0x3d, 0xba, 0xf6, 0x3a, 0xc1,
+  0x75, 0x6f, 0xe5, 0x52, 0x89, 0x8b, 0x82, 0xda, 0xe8, 0x72, 0x2b, 0x2e,
+  0x1a, 0x5a, 0x77, 0x25, 0x60, 0x34, 0x3c, 0x42, 0x86, 0xa1, 0x7d, 0xbb,
+  0xb2, 0x36, 0x74, 0xcd, 0xf2, 0x5a, 0x7c, 0x5b, 0x73, 0x90, 0x77, 0xd3,
+  0xeb, 0x3b, 0xbe, 0x20, 0xdd, 0x30, 0x83, 0xd7, 0x5a, 0xc4, 0x27, 0xf0,
+  0x35, 0xa0, 0xbb, 0x3b, 0xeb, 0xa9, 0xec, 0x55, 0xbf, 0xca, 0x5b, 0x42,
+  0xb1, 0x05, 0xd0, 0x56, 0xeb, 0x16, 0xe5, 0xee, 0xbb, 0xee, 0x86, 0x76,
+  0x4d, 0xd1, 0x15, 0x74, 0x90, 0xd7, 0xbd, 0x48, 0x7d, 0xe2, 0x22, 0x82,
+  0xf4, 0x66, 0xc5, 0x70, 0x18, 0xf9, 0x24, 0x80, 0x2f, 0x7c, 0x7c, 0x17,
+  0x66, 0x84, 0x1d, 0xf7, 0x6e, 0xff, 0xec, 0x1e, 0x4f, 0x48, 0x30, 0x0d,
+  0x48, 0xf0, 0x73, 0x04, 0xee, 0xa8, 0x73, 0xf7, 0x41, 0xc3, 0xee, 0x5b,
+  0x31, 0x99, 0x86, 0x81, 0x78, 0xb1, 0xc0, 0x86, 0xdb, 0x68, 0xba, 0x1a,
+  0x33, 0x68, 0xfc, 0xf8, 0x87, 0xaf, 0x8a, 0x84, 0x17, 0x5e, 0x2a, 0x25,
+  0xf4, 0xfd, 0xd3, 0xc3, 0xef, 0x54, 0x41, 0x8b, 0xb4, 0x16, 0x72, 0x2a,
+  0xf8, 0xad, 0x89, 0x95, 0xd4, 0x15, 0x53, 0x56, 0x3f, 0x37, 0xe9, 0x1b,
+  0xc8, 0x60, 0xa9, 0x67, 0xe7, 0x47, 0xbe, 0x81, 0xb1, 0x19, 0xba, 0x63,
+  0x18, 0xaa, 0x40, 0xcc, 0xbf, 0x0b, 0x0e, 0x6a, 0x3a, 0x30, 0xf0, 0xcf,
+  0x1c, 0xb1, 0x0a, 0x01, 0x1c, 0x84, 0x63, 0x15, 0x52, 0x79, 0xd0, 0xe5,
+  0x28, 0x3e, 0x9d, 0xa7, 0x66, 0x0c, 0xcc, 0x30, 0xba, 0x60, 0x1c, 0xf6,
+  0xb3, 0xd9, 0xeb, 0xff, 0x76, 0xfe, 0x05, 0x31, 0x02, 0x8b, 0x31, 0x8c,
+  0x06, 0x00, 0x00
+};
@@ -0,0 +1,133 @@
+// ***********************************************************************************
+// A stand-in for an MQTT-SN gateway on Linux, to test SEND2MQTTSN without a real gateway.
+//
+// It listens on a UDP port, decodes the QoS -1 PUBLISH datagrams of MQTT_SN.h
+//   ( MQTT-SN v1.2, 5.4.12 ) and prints the topic and the payload of each message.
+// The topics are pre-defined, as in a real gateway : ID=Name on the command line,
+//   a topic-ID without a name is printed as a number.
+// Other or malformed datagrams are reported with their length and type.
+//
+// Build and run, from the root of the repository :
+//     g++ -o /tmp/mqttsn_gateway test/MQTT_SN_Gateway.cpp
+//     /tmp/mqttsn_gateway 1884 1=fijnstof/out 2=fijnstof/burst
+// In Wifi_Settings.h, MQTTSN_Gateway_IP is the address of the Linux machine,
+//   MQTTSN_Gateway_Port the port ( default 1884 ), MQTTSN_Topic_ID the first ID.
+// Without a node, a datagram can be sent by hand, e.g. with bash :
+//     printf '\x0b\x0c\x61\x00\x01\x00\x00test' > /dev/udp/127.0.0.1/1884
+// ***********************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <map>
+#include <string>
+
+#define MQTTSN_PUBLISH           0x0C
+#define MQTTSN_FLAG_QOS_M1       0x60
+#define MQTTSN_FLAG_RETAIN       0x10
+#define MQTTSN_TOPIC_TYPE        0x03
+#define MQTTSN_TOPIC_PREDEFINED  0x01
+
+
+// ***********************************************************************************
+// Decode and print one datagram, returns false if it's not a valid QoS -1 PUBLISH
+// ***********************************************************************************
+bool Print_Datagram ( const uint8_t *P, int Size, const char *From,
+                      const std::map < int, std::string > &Topics ) {
+  int Length ;
+  int Pos ;
+  if ( ( Size >= 4 ) && ( P[0] == 0x01 ) ) {
+    Length = 256 * P[1] + P[2] ;
+    Pos    = 3 ;
+  }
+  else if ( Size >= 1 ) {
+    Length = P[0] ;
+    Pos    = 1 ;
+  }
+  else {
+    return false ;
+  }
+  // the length field covers the complete datagram, including itself
+  if ( ( Length != Size ) || ( Length < Pos + 6 ) ) {
+    printf ( "%s : malformed, %d bytes, length field %d\n", From, Size, Length ) ;
+    return false ;
+  }
+  int Type     = P [ Pos ] ;
+  int Flags    = P [ Pos + 1 ] ;
+  int Topic_ID = 256 * P [ Pos + 2 ] + P [ Pos + 3 ] ;
+  int Msg_ID   = 256 * P [ Pos + 4 ] + P [ Pos + 5 ] ;
+  if ( Type != MQTTSN_PUBLISH ) {
+    printf ( "%s : message type 0x%02X ignored, only PUBLISH is handled\n", From, Type ) ;
+    return false ;
+  }
+  if ( ( Flags & MQTTSN_FLAG_QOS_M1 ) != MQTTSN_FLAG_QOS_M1 ) {
+    printf ( "%s : PUBLISH with flags 0x%02X ignored, only QoS -1 is handled\n", From, Flags ) ;
+    return false ;
+  }
+  if ( ( Flags & MQTTSN_TOPIC_TYPE ) != MQTTSN_TOPIC_PREDEFINED ) {
+    printf ( "%s : PUBLISH with topic type %d ignored, only pre-defined topics\n", From, Flags & MQTTSN_TOPIC_TYPE ) ;
+    return false ;
+  }
+
+  std::map < int, std::string >::const_iterator Topic = Topics.find ( Topic_ID ) ;
+  printf ( "%s : ", From ) ;
+  if ( Topic != Topics.end () ) {
+    printf ( "%s", Topic -> second.c_str () ) ;
+  }
+  else {
+    printf ( "topic-ID %d", Topic_ID ) ;
+  }
+  printf ( "%s, msg-ID %d, %d bytes : %.*s\n", ( Flags & MQTTSN_FLAG_RETAIN ) ? " ( retained )" : "",
+           Msg_ID, Size - Pos - 6, Size - Pos - 6, (const char*) P + Pos + 6 ) ;
+  return true ;
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+int main ( int argc, char **argv ) {
+  int Port = ( argc > 1 ) ? atoi ( argv[1] ) : 1884 ;
+  std::map < int, std::string > Topics ;
+  for ( int i = 2; i < argc; i++ ) {
+    const char *Is = strchr ( argv[i], '=' ) ;
+    if ( Is == NULL ) {
+      fprintf ( stderr, "usage : %s [port] [topic-ID=topic ...]\n", argv[0] ) ;
+      return 2 ;
+    }
+    Topics [ atoi ( argv[i] ) ] = Is + 1 ;
+  }
+
+  int Socket = socket ( AF_INET, SOCK_DGRAM, 0 ) ;
+  struct sockaddr_in Address ;
+  memset ( &Address, 0, sizeof ( Address ) ) ;
+  Address.sin_family      = AF_INET ;
+  Address.sin_addr.s_addr = htonl ( INADDR_ANY ) ;
+  Address.sin_port        = htons ( Port ) ;
+  if ( ( Socket < 0 ) || ( bind ( Socket, (struct sockaddr*) &Address, sizeof ( Address ) ) < 0 ) ) {
+    perror ( "MQTT-SN gateway" ) ;
+    return 1 ;
+  }
+  printf ( "MQTT-SN gateway listening on UDP port %d\n", Port ) ;
+  fflush ( stdout ) ;
+
+  uint8_t Datagram [ 65536 ] ;
+  for ( ;; ) {
+    struct sockaddr_in Sender ;
+    socklen_t          Sender_Len = sizeof ( Sender ) ;
+    int Size = recvfrom ( Socket, Datagram, sizeof ( Datagram ), 0, (struct sockaddr*) &Sender, &Sender_Len ) ;
+    if ( Size < 0 ) {
+      perror ( "MQTT-SN gateway" ) ;
+      break ;
+    }
+    char From [ 32 ] ;
+    snprintf ( From, sizeof ( From ), "%s:%d", inet_ntoa ( Sender.sin_addr ), ntohs ( Sender.sin_port ) ) ;
+    Print_Datagram ( Datagram, Size, From, Topics ) ;
+    fflush ( stdout ) ;
+  }
+  close ( Socket ) ;
+  return 1 ;
+}
@@ -0,0 +1,188 @@
+// ***********************************************************************************
+// Simulated SDS011 for the host tests, a Stream that is used as the serial port
+//   of _Sensor_SDS011 ( constructor with a Stream ).
+//
+// Commands are answered with a C5 reply, as described in the protocol :
+//   0x02 reporting mode, 0x06 work / sleep, 0x07 firmware, 0x08 working period.
+// While working ( active mode ) a C0 data frame is sent every second,
+//   the values are taken from a trace, one value per second after the wake-up,
+//   after the end of the trace the last value is repeated.
+// The wake-up times are recorded, to check the schedule of the driver.
+//
+// A trace file has one line per second : PM2.5 and PM10 in ug/m3,
+//   lines starting with # are comments, an empty line starts a new working period.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _SDS011_Simulator_h
+#define _SDS011_Simulator_h
+
+#include <Arduino.h>
+
+struct _SDS011_Trace_Sample {
+  uint16_t PM_2_5 ;      // 0.1 ug/m3, as sent by the sensor
+  uint16_t PM_10 ;
+} ;
+typedef std::vector < _SDS011_Trace_Sample > _SDS011_Trace ;
+
+
+// ***********************************************************************************
+// Read a trace file, every working period is a separate trace
+// ***********************************************************************************
+std::vector < _SDS011_Trace > SDS011_Read_Traces ( const char *File_Name ) {
+  std::vector < _SDS011_Trace > Traces ;
+  FILE *File = fopen ( File_Name, "r" ) ;
+  if ( File == NULL ) {
+    return Traces ;
+  }
+  _SDS011_Trace Trace ;
+  char Line [ 200 ] ;
+  while ( fgets ( Line, sizeof ( Line ), File ) ) {
+    if ( Line[0] == '#' ) {
+      continue ;
+    }
+    float PM_2_5, PM_10 ;
+    if ( sscanf ( Line, "%f %f", &PM_2_5, &PM_10 ) == 2 ) {
+      Trace.push_back ( { uint16_t ( 10 * PM_2_5 + 0.5 ), uint16_t ( 10 * PM_10 + 0.5 ) } ) ;
+    }
+    else if ( ! Trace.empty () ) {
+      Traces.push_back ( Trace ) ;
+      Trace.clear () ;
+    }
+  }
+  if ( ! Trace.empty () ) {
+    Traces.push_back ( Trace ) ;
+  }
+  fclose ( File ) ;
+  return Traces ;
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _SDS011_Simulator : public Stream {
+  public:
+    _SDS011_Trace               Trace ;
+    bool                        Working   = true ;     // a sensor wakes up working
+    bool                        Query     = false ;
+    uint16_t                    ID        = 0xA160 ;
+    std::vector < unsigned long > Wake_Times ;
+    unsigned long               Frames_Sent = 0 ;
+
+    using Print::write ;
+
+    // ***********************************************************************
+    // Bytes from the driver, a complete command is executed
+    // ***********************************************************************
+    size_t write ( uint8_t c ) override {
+      if ( ( _Command_Len == 0 ) && ( c != 0xAA ) ) {
+        return 1 ;
+      }
+      _Command [ _Command_Len++ ] = c ;
+      if ( _Command_Len == SDS011_COMMAND_LEN ) {
+        _Command_Len = 0 ;
+        _Execute () ;
+      }
+      return 1 ;
+    }
+
+    int available () override {
+      _Update () ;
+      return _Output.size () ;
+    }
+
+    int read () override {
+      _Update () ;
+      if ( _Output.empty () ) {
+        return -1 ;
+      }
+      int c = _Output.front () ;
+      _Output.pop_front () ;
+      return c ;
+    }
+
+    int peek () override {
+      _Update () ;
+      return _Output.empty () ? -1 : _Output.front () ;
+    }
+
+  private:
+    uint8_t             _Command [ SDS011_COMMAND_LEN ] ;
+    int                 _Command_Len = 0 ;
+    std::deque < uint8_t > _Output ;
+    unsigned long       _Wake_Time  = 0 ;
+    unsigned long       _Last_Frame = 0 ;
+
+    void _Frame ( uint8_t Type, const uint8_t Data [6] ) {
+      uint8_t Sum = 0 ;
+      _Output.push_back ( 0xAA ) ;
+      _Output.push_back ( Type ) ;
+      for ( int i = 0; i < 6; i++ ) {
+        _Output.push_back ( Data [i] ) ;
+        Sum += Data [i] ;
+      }
+      _Output.push_back ( Sum ) ;
+      _Output.push_back ( 0xAB ) ;
+    }
+
+    void _Data_Frame () {
+      _SDS011_Trace_Sample S = { 0, 0 } ;
+      if ( ! Trace.empty () ) {
+        // the first frame is sent 1 second after the wake-up
+        unsigned long i = ( millis () - _Wake_Time ) / 1000 ;
+        i = ( i > 0 ) ? i - 1 : 0 ;
+        S = Trace [ min ( i, (unsigned long) Trace.size () - 1 ) ] ;
+      }
+      uint8_t Data [6] = { uint8_t ( S.PM_2_5 & 0xFF ), uint8_t ( S.PM_2_5 >> 8 ),
+                           uint8_t ( S.PM_10  & 0xFF ), uint8_t ( S.PM_10  >> 8 ),
+                           uint8_t ( ID >> 8 ), uint8_t ( ID & 0xFF ) } ;
+      _Frame ( 0xC0, Data ) ;
+      Frames_Sent += 1 ;
+    }
+
+    // a data frame every second while working ( active mode )
+    void _Update () {
+      while ( Working && ! Query && ( millis () - _Last_Frame >= 1000 ) ) {
+        _Last_Frame += 1000 ;
+        _Data_Frame () ;
+      }
+    }
+
+    void _Execute () {
+      uint8_t Cmd = _Command [2] ;
+      uint8_t Set = _Command [3] ;
+      uint8_t Data [6] = { Cmd, Set, _Command [4], 0, uint8_t ( ID >> 8 ), uint8_t ( ID & 0xFF ) } ;
+      switch ( Cmd ) {
+        case 0x02 :
+          if ( Set ) {
+            Query = _Command [4] ;
+          }
+          Data [2] = Query ;
+          break ;
+        case 0x04 :
+          _Data_Frame () ;
+          return ;
+        case 0x06 :
+          if ( Set ) {
+            if ( _Command [4] && ! Working ) {
+              _Wake_Time  = millis () ;
+              _Last_Frame = millis () ;
+              Wake_Times.push_back ( millis () ) ;
+            }
+            Working = _Command [4] ;
+          }
+          Data [2] = Working ;
+          break ;
+        case 0x07 :
+          Data [1] = 18 ;
+          Data [2] = 11 ;
+          Data [3] = 16 ;
+          break ;
+      }
+      _Frame ( 0xC5, Data ) ;
+    }
+} ;
+
+#endif
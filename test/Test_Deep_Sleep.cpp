@@ -0,0 +1,164 @@
+// ***********************************************************************************
+// Host test of the deep sleep cycle ( DEEP_SLEEP ), with a simulated SDS011.
+//
+// Every cycle is a boot of the ESP, as in setup and loop of FijnStofSensor.ino :
+//   - the state is read from the RTC memory and restored in a new driver object
+//   - the driver runs until the working period is done and the sensor sleeps
+//   - the ESP sleeps for Pause_Remaining_ms, the state is saved in the RTC memory
+//   - millis starts again at 0, the RTC memory and the SDS011 itself are kept
+// Checked :
+//   - Pause_Remaining_ms is the rest of the pause, so the working periods
+//     follow each other after the pause time of the driver
+//   - the adaptive pause time, laser on-time and counters survive the deep sleep
+//   - a power cycle or a corrupted RTC memory gives a cleared state
+//   - the energy budget ( awake / sleep time, duty cycle, mean current )
+// ***********************************************************************************
+#include <Arduino.h>
+#include "ext_def.h"
+#include <ESP8266WiFi.h>
+
+int    debug = 0 ;
+String esp_chipid ;
+char   msg [ 1000 ] ;
+
+#include "Sensor_SDS011.h"
+#include "Host_Test.h"
+#include "SDS011_Simulator.h"
+
+#define AWAKE_MA   80
+#define SLEEP_MA   0.02
+
+_SDS011_Simulator Sim ;
+unsigned long     Real_Time = 0 ;     // time since the first boot, millis restarts at every boot
+
+
+// ***********************************************************************************
+// One boot of the ESP, returns the time it was awake
+// ***********************************************************************************
+struct _Cycle {
+  bool          RTC_Valid ;
+  unsigned long Wake_Time ;           // real time of the wake-up of the SDS011
+  unsigned long Awake_ms ;
+  unsigned long Sleep_ms ;
+  int           Pause_Time_ms ;       // after the working period ( adapted )
+  unsigned long Laser_On_s ;
+} ;
+
+_Cycle Boot () {
+  _Cycle Cycle ;
+  Host_Millis = 0 ;
+
+  // *******************************
+  // setup
+  // *******************************
+  _RTC_State RTC_State ;
+  Cycle.RTC_Valid = RTC_State.Read () ;
+  RTC_State.Data.Boot_Count += 1 ;
+  _Sensor_SDS011 Sensor ( Sim ) ;
+  Sensor.Adaptive = true ;
+  Sensor.Set_Mode ( SDS011_MODE_ACTIVE ) ;
+  if ( Cycle.RTC_Valid ) {
+    Sensor.Restore_State ( RTC_State.Data.SDS ) ;
+  }
+  size_t Wakes = Sim.Wake_Times.size () ;
+
+  // *******************************
+  // loop, until the deep sleep
+  // *******************************
+  while ( ! ( ( Sensor.Window_Count > 0 ) && Sensor.Sleeping () && ! Sensor.Commands_Pending () ) ) {
+    Sensor.loop () ;
+    Host_Advance ( 100 ) ;
+  }
+  Cycle.Wake_Time = ( Sim.Wake_Times.size () > Wakes ) ? Real_Time + Sim.Wake_Times.back () : Real_Time ;
+
+  // ***********************************************************
+  // Deep_Sleep, the remaining pause is measured from the end
+  //   of the working period, before the sleep commands finished
+  // ***********************************************************
+  unsigned long Remaining = Sensor.Pause_Remaining_ms ( millis () ) ;
+  CHECK ( Remaining <= (unsigned long) Sensor.Pause_Time_ms ) ;
+  CHECK ( Remaining + 2000 > (unsigned long) Sensor.Pause_Time_ms ) ;
+  CHECK ( Sensor.Pause_Remaining_ms ( millis () + Remaining ) == 0 ) ;
+
+  Cycle.Awake_ms      = millis () ;
+  Cycle.Sleep_ms      = Remaining ;
+  Cycle.Pause_Time_ms = Sensor.Pause_Time_ms ;
+  Cycle.Laser_On_s    = Sensor.Laser_On_s ;
+  RTC_State.Add_Cycle ( Cycle.Awake_ms, Cycle.Sleep_ms ) ;
+  RTC_State.Data.Send_Sequence += 1 ;
+  Sensor.Save_State ( RTC_State.Data.SDS ) ;
+  RTC_State.Write () ;
+  ESP.deepSleep ( 1000ULL * Remaining, RF_DEFAULT ) ;
+  CHECK ( ESP.Deep_Sleep_us == 1000ULL * Remaining ) ;
+
+  Real_Time += Cycle.Awake_ms + Cycle.Sleep_ms ;
+  return Cycle ;
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+int main () {
+  // stable air, so the adaptive pause time grows every working period
+  Sim.Trace = { { 100, 140 } } ;
+  memset ( ESP.RTC_Memory, 0x5A, sizeof ( ESP.RTC_Memory ) ) ;
+
+  std::vector < _Cycle > Cycles ;
+  for ( int i = 0; i < 8; i++ ) {
+    Cycles.push_back ( Boot () ) ;
+  }
+
+  // *************************************************
+  // the first boot is a power-on, the others restore
+  // *************************************************
+  CHECK ( ! Cycles[0].RTC_Valid ) ;
+  int Pause = 120000 ;
+  for ( size_t i = 0; i < Cycles.size (); i++ ) {
+    if ( i > 0 ) {
+      CHECK ( Cycles[i].RTC_Valid ) ;
+      // the sensor wakes up right after the pause
+      unsigned long Gap = Cycles[i].Wake_Time - ( Cycles[i-1].Wake_Time + Cycles[i-1].Awake_ms ) ;
+      CHECK ( Gap <= (unsigned long) Cycles[i-1].Pause_Time_ms + 100 ) ;
+      // the laser on-time is cumulative
+      CHECK ( Cycles[i].Laser_On_s > Cycles[i-1].Laser_On_s ) ;
+    }
+    // the adapted pause time survives the deep sleep
+    Pause = constrain ( Pause + Pause / 2, 60000, 900000 ) ;
+    CHECK ( Cycles[i].Pause_Time_ms == Pause ) ;
+  }
+  CHECK ( Cycles.back ().Pause_Time_ms == 900000 ) ;
+
+  // *************************************************
+  // energy budget
+  // *************************************************
+  _RTC_State RTC_State ;
+  CHECK ( RTC_State.Read () ) ;
+  unsigned long Awake_ms = 0 ;
+  unsigned long Sleep_ms = 0 ;
+  for ( const _Cycle &Cycle : Cycles ) {
+    Awake_ms += Cycle.Awake_ms ;
+    Sleep_ms += Cycle.Sleep_ms ;
+  }
+  CHECK ( RTC_State.Data.Boot_Count     == Cycles.size () ) ;
+  CHECK ( RTC_State.Data.Send_Sequence  == Cycles.size () ) ;
+  CHECK ( RTC_State.Data.Awake_ms_Total == Awake_ms ) ;
+  CHECK ( RTC_State.Data.Sleep_ms_Total == Sleep_ms ) ;
+  double Duty    = double ( Awake_ms ) / ( Awake_ms + Sleep_ms ) ;
+  double Current = Duty * AWAKE_MA + ( 1 - Duty ) * SLEEP_MA ;
+  CHECK ( fabs ( RTC_State.Duty_Cycle () - Duty ) < 1e-5 ) ;
+  CHECK ( fabs ( RTC_State.Mean_Current_mA ( AWAKE_MA, SLEEP_MA ) - Current ) < 1e-3 ) ;
+  printf ( "  %d cycles, awake %.1f s, sleep %.1f s, duty cycle %.2f %%, mean current %.2f mA\n",
+           (int) Cycles.size (), 0.001 * Awake_ms, 0.001 * Sleep_ms, 100 * Duty, Current ) ;
+
+  // *************************************************
+  // a corrupted state and a power cycle are cleared
+  // *************************************************
+  ESP.RTC_Memory [ 4 * RTC_STATE_OFFSET + 20 ] ^= 0x01 ;
+  CHECK ( ! RTC_State.Read () ) ;
+  CHECK ( RTC_State.Data.Boot_Count == 0 ) ;
+  CHECK ( RTC_State.Duty_Cycle () == 0 ) ;
+  memset ( ESP.RTC_Memory, 0, sizeof ( ESP.RTC_Memory ) ) ;
+  CHECK ( ! RTC_State.Read () ) ;
+
+  return Test_Result ( "Deep_Sleep" ) ;
+}
@@ -0,0 +1,260 @@
+// ***********************************************************************************
+// Host test of the table driven frame parser ( Frame_Parser.h ).
+//
+// Streams of valid frames are mixed with random bytes, corrupted frames and
+//   truncated frames ( lost bytes ), with a fixed seed so every run is the same.
+// Checked :
+//   - every intact frame is found, in order, and nothing else
+//   - corrupted frames are counted as checksum or sync errors and not returned
+//   - after a truncated frame the parser finds the next frame ( resync )
+//   - on pure random data every returned frame is really valid
+// At the end the throughput of the parser is printed.
+// ***********************************************************************************
+#include <Arduino.h>
+#include <time.h>
+#include "Host_Test.h"
+#include "Frame_Parser.h"
+
+typedef std::vector<uint8_t> _Bytes ;
+
+
+// ***********************************************************************************
+// Deterministic random numbers ( xorshift32 )
+// ***********************************************************************************
+uint32_t Random_State = 12345 ;
+
+uint32_t Random () {
+  Random_State ^= Random_State << 13 ;
+  Random_State ^= Random_State >> 17 ;
+  Random_State ^= Random_State << 5 ;
+  return Random_State ;
+}
+
+int Random ( int N ) {
+  return Random () % N ;
+}
+
+
+// ***********************************************************************************
+// Frame builders
+// ***********************************************************************************
+_Bytes SDS011_Frame ( uint8_t Type ) {
+  _Bytes F = { 0xAA, Type } ;
+  uint8_t Sum = 0 ;
+  for ( int i = 0; i < 6; i++ ) {
+    F.push_back ( Random ( 256 ) ) ;
+    Sum += F.back () ;
+  }
+  F.push_back ( Sum ) ;
+  F.push_back ( 0xAB ) ;
+  return F ;
+}
+
+// Length = number of bytes after the length field ( 20 for PMS3003, 28 for PMS7003 )
+_Bytes PMS_Frame ( int Length ) {
+  _Bytes F = { 0x42, 0x4D, 0x00, (uint8_t) Length } ;
+  for ( int i = 0; i < Length - 2; i++ ) {
+    F.push_back ( Random ( 256 ) ) ;
+  }
+  uint16_t Sum = 0 ;
+  for ( uint8_t b : F ) {
+    Sum += b ;
+  }
+  F.push_back ( Sum >> 8 ) ;
+  F.push_back ( Sum & 0xFF ) ;
+  return F ;
+}
+
+// ***********************************************************************************
+// Independent check of a returned frame
+// ***********************************************************************************
+bool SDS011_Valid ( const uint8_t *F, int Len ) {
+  uint8_t Sum = 0 ;
+  for ( int i = 2; i < 8; i++ ) {
+    Sum += F[i] ;
+  }
+  return ( Len == 10 ) && ( F[0] == 0xAA ) && ( F[1] == 0xC0 || F[1] == 0xC5 ) && ( F[8] == Sum ) && ( F[9] == 0xAB ) ;
+}
+
+bool PMS_Valid ( const uint8_t *F, int Len ) {
+  if ( ( Len < 8 ) || ( F[0] != 0x42 ) || ( F[1] != 0x4D ) || ( 4 + 256 * F[2] + F[3] != Len ) ) {
+    return false ;
+  }
+  uint16_t Sum = 0 ;
+  for ( int i = 0; i < Len - 2; i++ ) {
+    Sum += F[i] ;
+  }
+  return ( 256 * F [ Len - 2 ] + F [ Len - 1 ] ) == Sum ;
+}
+
+// ***********************************************************************************
+// Feed a stream, returns all frames that the parser reports
+// ***********************************************************************************
+template < typename Descriptor >
+std::vector<_Bytes> Parse ( _Frame_Parser < Descriptor > &Parser, const _Bytes &Stream ) {
+  std::vector<_Bytes> Frames ;
+  for ( uint8_t b : Stream ) {
+    if ( Parser.Feed ( b ) ) {
+      Frames.push_back ( _Bytes ( Parser.Frame, Parser.Frame + Parser.Frame_Len ) ) ;
+    }
+  }
+  return Frames ;
+}
+
+// random bytes, without the first header byte ( Avoid ), or any byte if Avoid < 0
+void Add_Noise ( _Bytes &Stream, int N, int Avoid ) {
+  for ( int i = 0; i < N; i++ ) {
+    uint8_t b = Random ( 256 ) ;
+    if ( b == Avoid ) {
+      b ^= 0x01 ;
+    }
+    Stream.push_back ( b ) ;
+  }
+}
+
+
+// ***********************************************************************************
+// Frames with noise between them, optionally corrupted or truncated frames.
+// Intact frames must all be found, in order, and nothing else.
+// ***********************************************************************************
+enum _Damage { NONE, CORRUPT, TRUNCATE } ;
+
+template < typename Descriptor >
+void Test_Stream ( _Bytes ( *Build ) (), int Avoid, _Damage Damage, int N_Frames ) {
+  _Frame_Parser < Descriptor > Parser ;
+  std::vector<_Bytes> Expected ;
+  _Bytes Stream ;
+  int    Damaged = 0 ;
+  for ( int i = 0; i < N_Frames; i++ ) {
+    Add_Noise ( Stream, Random ( 4 ), Avoid ) ;
+    _Bytes F = Build () ;
+    if ( ( Damage != NONE ) && ( Random ( 4 ) == 0 ) ) {
+      Damaged += 1 ;
+      if ( Damage == CORRUPT ) {
+        // one bit flipped after the header, so it's a checksum, length or tail error
+        F [ 2 + Random ( F.size () - 2 ) ] ^= 1 << Random ( 8 ) ;
+      }
+      else {
+        // lost bytes, anywhere after the header, at least 2 bytes,
+        //   a frame that only lost its last byte is completed by the next byte
+        //   and that's really a valid frame if that byte happens to be right
+        F.resize ( 2 + Random ( F.size () - 3 ) ) ;
+      }
+    }
+    else {
+      Expected.push_back ( F ) ;
+    }
+    Stream.insert ( Stream.end (), F.begin (), F.end () ) ;
+  }
+  std::vector<_Bytes> Found = Parse ( Parser, Stream ) ;
+  CHECK ( Found == Expected ) ;
+  CHECK ( Parser.Frames_OK == Expected.size () ) ;
+  if ( Damage == CORRUPT ) {
+    CHECK ( Parser.Checksum_Errors + Parser.Sync_Errors >= (unsigned long) Damaged ) ;
+  }
+  if ( Found != Expected ) {
+    printf ( "  expected %d frames, found %d ( damaged %d )\n", (int) Expected.size (), (int) Found.size (), Damaged ) ;
+  }
+}
+
+_Bytes SDS011_Data () { return SDS011_Frame ( 0xC0 ) ; }
+_Bytes SDS011_Any  () { return SDS011_Frame ( Random ( 2 ) ? 0xC0 : 0xC5 ) ; }
+_Bytes PMS_Any     () { return PMS_Frame ( Random ( 2 ) ? 20 : 28 ) ; }
+
+
+// ***********************************************************************************
+// Pure random data : whatever is returned must be a valid frame
+// ***********************************************************************************
+template < typename Descriptor >
+void Test_Random ( bool ( *Valid ) ( const uint8_t*, int ), int N_Bytes ) {
+  _Frame_Parser < Descriptor > Parser ;
+  _Bytes Stream ;
+  Add_Noise ( Stream, N_Bytes, -1 ) ;
+  std::vector<_Bytes> Found = Parse ( Parser, Stream ) ;
+  bool All_Valid = true ;
+  for ( const _Bytes &F : Found ) {
+    All_Valid = All_Valid && Valid ( F.data (), F.size () ) ;
+  }
+  CHECK ( All_Valid ) ;
+  CHECK ( Parser.Frames_OK == Found.size () ) ;
+}
+
+
+// ***********************************************************************************
+// A frame that starts inside a truncated frame
+// ***********************************************************************************
+void Test_Resync () {
+  _Frame_Parser < _Frame_SDS011 > Parser ;
+  _Bytes First  = SDS011_Data () ;
+  _Bytes Second = SDS011_Data () ;
+  _Bytes Stream ( First.begin (), First.begin () + 6 ) ;
+  Stream.insert ( Stream.end (), Second.begin (), Second.end () ) ;
+  std::vector<_Bytes> Found = Parse ( Parser, Stream ) ;
+  CHECK ( Found.size () == 1 ) ;
+  CHECK ( ( Found.size () == 1 ) && ( Found[0] == Second ) ) ;
+  CHECK ( Parser.Sync_Errors == 1 ) ;
+
+  // two frames back to back, after a bad PMS length field
+  _Frame_Parser < _Frame_PMS > PMS ;
+  _Bytes P1 = PMS_Frame ( 28 ) ;
+  _Bytes P2 = PMS_Frame ( 20 ) ;
+  Stream = { 0x42, 0x4D, 0x7F, 0x42 } ;
+  Stream.insert ( Stream.end (), P1.begin (), P1.end () ) ;
+  Stream.insert ( Stream.end (), P2.begin (), P2.end () ) ;
+  Found = Parse ( PMS, Stream ) ;
+  CHECK ( ( Found.size () == 2 ) && ( Found[0] == P1 ) && ( Found[1] == P2 ) ) ;
+
+  // Reset drops a partial frame
+  Parser.Reset () ;
+  Stream.assign ( First.begin (), First.begin () + 5 ) ;
+  Parse ( Parser, Stream ) ;
+  Parser.Reset () ;
+  Found = Parse ( Parser, Second ) ;
+  CHECK ( ( Found.size () == 1 ) && ( Found[0] == Second ) ) ;
+}
+
+
+// ***********************************************************************************
+// Throughput on valid SDS011 frames
+// ***********************************************************************************
+void Throughput () {
+  _Frame_Parser < _Frame_SDS011 > Parser ;
+  _Bytes Stream ;
+  for ( int i = 0; i < 100000; i++ ) {
+    _Bytes F = SDS011_Data () ;
+    Stream.insert ( Stream.end (), F.begin (), F.end () ) ;
+  }
+  int     Rounds = 20 ;
+  clock_t Start  = clock () ;
+  for ( int r = 0; r < Rounds; r++ ) {
+    for ( uint8_t b : Stream ) {
+      Parser.Feed ( b ) ;
+    }
+  }
+  double Seconds = double ( clock () - Start ) / CLOCKS_PER_SEC ;
+  CHECK ( Parser.Frames_OK == 100000UL * Rounds ) ;
+  if ( Seconds > 0 ) {
+    printf ( "  throughput %.1f MB/s, %.2f M frames/s ( host )\n",
+             Rounds * Stream.size () / Seconds / 1e6, Rounds * 100000 / Seconds / 1e6 ) ;
+  }
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+int main () {
+  Test_Stream < _Frame_SDS011 > ( SDS011_Any,  0xAA, NONE,     2000 ) ;
+  Test_Stream < _Frame_SDS011 > ( SDS011_Any,  -1,   NONE,     2000 ) ;
+  Test_Stream < _Frame_SDS011 > ( SDS011_Data, 0xAA, CORRUPT,  2000 ) ;
+  Test_Stream < _Frame_SDS011 > ( SDS011_Data, 0xAA, TRUNCATE, 2000 ) ;
+  Test_Stream < _Frame_SDS011 > ( SDS011_Any,  -1,   TRUNCATE, 2000 ) ;
+  Test_Stream < _Frame_PMS >    ( PMS_Any,     0x42, NONE,     2000 ) ;
+  Test_Stream < _Frame_PMS >    ( PMS_Any,     -1,   NONE,     2000 ) ;
+  Test_Stream < _Frame_PMS >    ( PMS_Any,     0x42, CORRUPT,  2000 ) ;
+  Test_Stream < _Frame_PMS >    ( PMS_Any,     0x42, TRUNCATE, 2000 ) ;
+  Test_Random < _Frame_SDS011 > ( SDS011_Valid, 1000000 ) ;
+  Test_Random < _Frame_PMS >    ( PMS_Valid,    1000000 ) ;
+  Test_Resync () ;
+  Throughput () ;
+  return Test_Result ( "Frame_Parser" ) ;
+}
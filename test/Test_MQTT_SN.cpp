@@ -0,0 +1,168 @@
+// ***********************************************************************************
+// Host test of the MQTT-SN publisher ( MQTT_SN.h ).
+//
+// The UDP datagrams are decoded as a gateway would do ( MQTT-SN v1.2, 5.4.12 PUBLISH ) :
+//   Length ( 1 byte, or 0x01 + 2 bytes above 255 ), MsgType, Flags, TopicId, MsgId, Data
+// and checked for the QoS -1 flags, the pre-defined topic-ID and the length forms.
+// ***********************************************************************************
+#define MQTT_MAX_PACKET_SIZE 1100
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <vector>
+#include "Host_Test.h"
+#include "MQTT_SN.h"
+
+
+// ***********************************************************************************
+// The fields of a decoded PUBLISH, Valid = false if the datagram is malformed
+// ***********************************************************************************
+struct _Decoded {
+  bool        Valid = false ;
+  int         Length_Bytes ;
+  int         Type ;
+  int         Flags ;
+  int         Topic_ID ;
+  int         Msg_ID ;
+  std::string Data ;
+} ;
+
+_Decoded Decode ( const std::vector<uint8_t> &P ) {
+  _Decoded D ;
+  if ( P.size () < 2 ) {
+    return D ;
+  }
+  unsigned int Length ;
+  int          Pos ;
+  if ( P[0] == 0x01 ) {
+    if ( P.size () < 4 ) {
+      return D ;
+    }
+    Length = 256 * P[1] + P[2] ;
+    Pos    = 3 ;
+  }
+  else {
+    Length = P[0] ;
+    Pos    = 1 ;
+  }
+  // the length field covers the complete datagram, including itself
+  if ( ( Length != P.size () ) || ( Length < Pos + 6u ) ) {
+    return D ;
+  }
+  D.Length_Bytes = Pos ;
+  D.Type         = P [ Pos ] ;
+  D.Flags        = P [ Pos + 1 ] ;
+  D.Topic_ID     = 256 * P [ Pos + 2 ] + P [ Pos + 3 ] ;
+  D.Msg_ID       = 256 * P [ Pos + 4 ] + P [ Pos + 5 ] ;
+  D.Data.assign ( P.begin () + Pos + 6, P.end () ) ;
+  D.Valid = true ;
+  return D ;
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+int main () {
+  WiFiUDP  UDP ;
+  _MQTT_SN mqttsn ( UDP ) ;
+
+  // *********************************************************
+  // no gateway and no topic : nothing is sent
+  // *********************************************************
+  CHECK ( ! mqttsn.publish ( "fijnstof/out", "x" ) ) ;
+  mqttsn.setServer ( "192.168.0.10", 1884 ) ;
+  CHECK ( ! mqttsn.publish ( "fijnstof/out", "x" ) ) ;
+  CHECK ( UDP.Packets.size () == 0 ) ;
+  CHECK ( mqttsn.Publish_Error == 2 ) ;
+
+  CHECK ( mqttsn.Add_Topic ( "fijnstof/out",   0x0102 ) ) ;
+  CHECK ( mqttsn.Add_Topic ( "fijnstof/burst", 0x0103 ) ) ;
+
+  // *********************************************************
+  // short form of the length, QoS -1 and a pre-defined topic
+  // *********************************************************
+  CHECK ( mqttsn.publish ( "fijnstof/out", "[12.3,45.6]" ) ) ;
+  CHECK ( UDP.Packets.size () == 1 ) ;
+  CHECK ( UDP.Packets[0].Host == "192.168.0.10" ) ;
+  CHECK ( UDP.Packets[0].Port == 1884 ) ;
+  _Decoded D = Decode ( UDP.Packets[0].Data ) ;
+  CHECK ( D.Valid ) ;
+  CHECK ( D.Length_Bytes == 1 ) ;
+  CHECK ( D.Type == MQTTSN_PUBLISH ) ;
+  CHECK ( ( D.Flags & 0x60 ) == 0x60 ) ;          // QoS -1
+  CHECK ( ( D.Flags & 0x03 ) == 0x01 ) ;          // pre-defined topic-ID
+  CHECK ( ( D.Flags & 0x10 ) == 0 ) ;             // not retained
+  CHECK ( ( D.Flags & 0x80 ) == 0 ) ;             // no DUP
+  CHECK ( D.Topic_ID == 0x0102 ) ;
+  CHECK ( D.Msg_ID == 0 ) ;
+  CHECK ( D.Data == "[12.3,45.6]" ) ;
+
+  // *********************************************************
+  // second topic, retained
+  // *********************************************************
+  CHECK ( mqttsn.publish ( "fijnstof/burst", "b", true ) ) ;
+  D = Decode ( UDP.Packets.back ().Data ) ;
+  CHECK ( D.Valid ) ;
+  CHECK ( D.Topic_ID == 0x0103 ) ;
+  CHECK ( ( D.Flags & 0x10 ) == 0x10 ) ;
+  CHECK ( D.Data == "b" ) ;
+
+  // *********************************************************
+  // the largest datagram with the short form : 255 bytes
+  // *********************************************************
+  std::string Payload ( 255 - 7, 'a' ) ;
+  CHECK ( mqttsn.publish ( "fijnstof/out", Payload.c_str () ) ) ;
+  D = Decode ( UDP.Packets.back ().Data ) ;
+  CHECK ( D.Valid ) ;
+  CHECK ( D.Length_Bytes == 1 ) ;
+  CHECK ( UDP.Packets.back ().Data.size () == 255 ) ;
+  CHECK ( D.Data == Payload ) ;
+
+  // *********************************************************
+  // above 255 bytes the 3 byte length form is used
+  // *********************************************************
+  Payload = std::string ( 255 - 7 + 1, 'b' ) ;
+  CHECK ( mqttsn.publish ( "fijnstof/out", Payload.c_str () ) ) ;
+  D = Decode ( UDP.Packets.back ().Data ) ;
+  CHECK ( D.Valid ) ;
+  CHECK ( D.Length_Bytes == 3 ) ;
+  CHECK ( UDP.Packets.back ().Data.size () == 256 + 2 ) ;
+  CHECK ( D.Type == MQTTSN_PUBLISH ) ;
+  CHECK ( D.Topic_ID == 0x0102 ) ;
+  CHECK ( D.Data == Payload ) ;
+
+  Payload = std::string ( 1000, 'c' ) ;
+  CHECK ( mqttsn.publish ( "fijnstof/out", Payload.c_str () ) ) ;
+  D = Decode ( UDP.Packets.back ().Data ) ;
+  CHECK ( D.Valid ) ;
+  CHECK ( D.Length_Bytes == 3 ) ;
+  CHECK ( D.Data == Payload ) ;
+
+  // *********************************************************
+  // too large for the packet buffer of the gateway
+  // *********************************************************
+  size_t Sent = UDP.Packets.size () ;
+  Payload = std::string ( MQTTSN_MAX_PACKET_SIZE, 'd' ) ;
+  CHECK ( ! mqttsn.publish ( "fijnstof/out", Payload.c_str () ) ) ;
+  CHECK ( UDP.Packets.size () == Sent ) ;
+
+  // *********************************************************
+  // unknown topic and a failing socket
+  // *********************************************************
+  CHECK ( ! mqttsn.publish ( "fijnstof/unknown", "x" ) ) ;
+  UDP.Fail = true ;
+  CHECK ( ! mqttsn.publish ( "fijnstof/out", "x" ) ) ;
+  CHECK ( UDP.Packets.size () == Sent ) ;
+  CHECK ( mqttsn.Publish_Count == Sent ) ;
+  CHECK ( mqttsn.Publish_Error == 2 + 3 ) ;
+
+  // *********************************************************
+  // the topic table is limited
+  // *********************************************************
+  for ( int i = 2; i < MQTTSN_MAX_TOPICS; i++ ) {
+    CHECK ( mqttsn.Add_Topic ( "t", i ) ) ;
+  }
+  CHECK ( ! mqttsn.Add_Topic ( "t", 99 ) ) ;
+
+  return Test_Result ( "MQTT_SN" ) ;
+}
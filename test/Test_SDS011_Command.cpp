@@ -0,0 +1,114 @@
+// ***********************************************************************************
+// Host test of the SDS011 command builder ( SDS011_Command.h ), at runtime.
+//
+// The static_asserts in SDS011_Command.h only check constant commands,
+//   here the Device-ID's and working periods are runtime values,
+//   as the driver uses them ( e.g. Set_Mode with a configurable period ).
+// Checked :
+//   - the commands against the complete byte sequences of the examples
+//     in "Laser Dust Sensor Control Protocol_V1.4.pdf" ( sensor A160 or all, FFFF )
+//   - all working periods 0 .. 30 and a range of Device-ID's :
+//     header, data bytes, ID, checksum ( sum of byte 2 .. 16 ) and tail
+//   - the fixed commands in flash are the same as built at runtime
+// ***********************************************************************************
+#include <Arduino.h>
+#include "SDS011_Command.h"
+#include "Host_Test.h"
+
+
+// ***********************************************************************************
+// A command as written in the protocol description, e.g. "AA B4 06 01 00 ... AB"
+// ***********************************************************************************
+bool Same ( const _SDS011_Command &Command, const char *Hex ) {
+  for ( int i = 0; i < SDS011_COMMAND_LEN; i++ ) {
+    unsigned int Byte ;
+    if ( sscanf ( Hex + 3 * i, "%2x", &Byte ) != 1 ) {
+      return false ;
+    }
+    if ( Command.Bytes [i] != Byte ) {
+      printf ( "  byte %d : %02X, expected %02X in %s\n", i, Command.Bytes [i], Byte, Hex ) ;
+      return false ;
+    }
+  }
+  return true ;
+}
+
+// ***********************************************************************************
+// The fields of a command, calculated without the builder
+// ***********************************************************************************
+bool Valid ( const _SDS011_Command &C, uint8_t Cmd, uint8_t Data_1, uint8_t Data_2, uint16_t New_ID, uint16_t ID ) {
+  uint8_t Sum = 0 ;
+  for ( int i = 2; i <= 16; i++ ) {
+    Sum += C.Bytes [i] ;
+  }
+  bool Zero = true ;
+  for ( int i = 5; i <= 12; i++ ) {
+    Zero = Zero && ( C.Bytes [i] == 0 ) ;
+  }
+  return ( C.Bytes [0] == 0xAA ) && ( C.Bytes [1] == 0xB4 ) && ( C.Bytes [2] == Cmd ) &&
+         ( C.Bytes [3] == Data_1 ) && ( C.Bytes [4] == Data_2 ) && Zero &&
+         ( 256 * C.Bytes [13] + C.Bytes [14] == New_ID ) &&
+         ( 256 * C.Bytes [15] + C.Bytes [16] == ID ) &&
+         ( C.Bytes [17] == Sum ) && ( C.Bytes [18] == 0xAB ) ;
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+int main () {
+  // runtime values, so the builders are not evaluated by the compiler
+  volatile uint16_t ID_A160  = 0xA160 ;
+  volatile uint16_t ID_A001  = 0xA001 ;
+  volatile uint16_t ID_All   = SDS011_ALL_DEVICES ;
+  volatile uint8_t  Minutes  = 1 ;
+  volatile bool     True     = true ;
+
+  // *************************************************
+  // the examples of the protocol description
+  // *************************************************
+  CHECK ( Same ( SDS011_Get_Reporting_Mode ( ID_All ),           "AA B4 02 00 00 00 00 00 00 00 00 00 00 00 00 FF FF 00 AB" ) ) ;
+  CHECK ( Same ( SDS011_Set_Reporting_Mode ( True, ID_A160 ),    "AA B4 02 01 01 00 00 00 00 00 00 00 00 00 00 A1 60 05 AB" ) ) ;
+  CHECK ( Same ( SDS011_Set_Reporting_Mode ( ! True, ID_A160 ),  "AA B4 02 01 00 00 00 00 00 00 00 00 00 00 00 A1 60 04 AB" ) ) ;
+  CHECK ( Same ( SDS011_Query_Data ( ID_All ),                   "AA B4 04 00 00 00 00 00 00 00 00 00 00 00 00 FF FF 02 AB" ) ) ;
+  CHECK ( Same ( SDS011_Set_Device_ID ( ID_A001, ID_A160 ),      "AA B4 05 00 00 00 00 00 00 00 00 00 00 A0 01 A1 60 A7 AB" ) ) ;
+  CHECK ( Same ( SDS011_Set_Work ( ! True, ID_A160 ),            "AA B4 06 01 00 00 00 00 00 00 00 00 00 00 00 A1 60 08 AB" ) ) ;
+  CHECK ( Same ( SDS011_Set_Work ( True, ID_A160 ),              "AA B4 06 01 01 00 00 00 00 00 00 00 00 00 00 A1 60 09 AB" ) ) ;
+  CHECK ( Same ( SDS011_Get_Work ( ID_A160 ),                    "AA B4 06 00 00 00 00 00 00 00 00 00 00 00 00 A1 60 07 AB" ) ) ;
+  CHECK ( Same ( SDS011_Set_Working_Period ( Minutes, ID_A160 ), "AA B4 08 01 01 00 00 00 00 00 00 00 00 00 00 A1 60 0B AB" ) ) ;
+  CHECK ( Same ( SDS011_Set_Working_Period ( 0, ID_A160 ),       "AA B4 08 01 00 00 00 00 00 00 00 00 00 00 00 A1 60 0A AB" ) ) ;
+  CHECK ( Same ( SDS011_Get_Working_Period ( ID_A160 ),          "AA B4 08 00 00 00 00 00 00 00 00 00 00 00 00 A1 60 09 AB" ) ) ;
+  CHECK ( Same ( SDS011_Get_Firmware ( ID_A160 ),                "AA B4 07 00 00 00 00 00 00 00 00 00 00 00 00 A1 60 08 AB" ) ) ;
+
+  // *************************************************
+  // all working periods, a range of Device-ID's
+  // *************************************************
+  for ( int Period = 0; Period <= 30; Period++ ) {
+    CHECK ( Valid ( SDS011_Set_Working_Period ( Period ), 0x08, 0x01, Period, 0x0000, 0xFFFF ) ) ;
+  }
+  int Failed = 0 ;
+  for ( uint32_t ID = 0; ID <= 0xFFFF; ID += 0x0101 ) {
+    for ( int Period = 0; Period <= 30; Period += 6 ) {
+      Failed += ! Valid ( SDS011_Set_Working_Period ( Period, ID ), 0x08, 0x01, Period, 0x0000, ID ) ;
+    }
+    Failed += ! Valid ( SDS011_Set_Work       ( true,  ID ),        0x06, 0x01, 0x01, 0x0000, ID ) ;
+    Failed += ! Valid ( SDS011_Set_Work       ( false, ID ),        0x06, 0x01, 0x00, 0x0000, ID ) ;
+    Failed += ! Valid ( SDS011_Query_Data     ( ID ),               0x04, 0x00, 0x00, 0x0000, ID ) ;
+    Failed += ! Valid ( SDS011_Set_Device_ID  ( ~ID & 0xFFFF, ID ), 0x05, 0x00, 0x00, ~ID & 0xFFFF, ID ) ;
+  }
+  CHECK ( Failed == 0 ) ;
+
+  // *************************************************
+  // the fixed commands in flash
+  // *************************************************
+  _SDS011_Command Flash ;
+  memcpy_P ( &Flash, &SDS011_CMD_WORK, sizeof ( Flash ) ) ;
+  CHECK ( Same ( Flash, "AA B4 06 01 01 00 00 00 00 00 00 00 00 00 00 FF FF 06 AB" ) ) ;
+  memcpy_P ( &Flash, &SDS011_CMD_SLEEP, sizeof ( Flash ) ) ;
+  CHECK ( Same ( Flash, "AA B4 06 01 00 00 00 00 00 00 00 00 00 00 00 FF FF 05 AB" ) ) ;
+  memcpy_P ( &Flash, &SDS011_CMD_QUERY, sizeof ( Flash ) ) ;
+  CHECK ( Same ( Flash, "AA B4 04 00 00 00 00 00 00 00 00 00 00 00 00 FF FF 02 AB" ) ) ;
+  memcpy_P ( &Flash, &SDS011_CMD_FIRMWARE, sizeof ( Flash ) ) ;
+  CHECK ( Same ( Flash, "AA B4 07 00 00 00 00 00 00 00 00 00 00 00 00 FF FF 05 AB" ) ) ;
+
+  return Test_Result ( "SDS011_Command" ) ;
+}
@@ -0,0 +1,87 @@
+// ***********************************************************************************
+// Host test of the SDS011 driver through a pseudo terminal ( test/host/Host_PTY.h ),
+//   the simulated SDS011 on the master side, the driver on the raw tty.
+//
+// The values and the ID of the sensor hold the bytes a tty in its default mode
+//   would change or act on : LF, CR, ^C, XON, XOFF and DEL.
+// Checked :
+//   - every frame of the sensor arrives unchanged : no checksum or sync errors
+//   - the commands reach the sensor : it wakes up, measures and sleeps again
+//   - the mean of the working periods is the value sent by the sensor
+// ***********************************************************************************
+#include <chrono>
+#include <Arduino.h>
+#include "ext_def.h"
+#include <ESP8266WiFi.h>
+
+int    debug = 0 ;
+String esp_chipid ;
+char   msg [ 1000 ] ;
+
+#include "Sensor_SDS011.h"
+#include "Host_Test.h"
+#include "Host_PTY.h"
+#include "SDS011_Simulator.h"
+
+#define WINDOWS   3
+
+int   Windows = 0 ;
+float Mean_2_5 ;
+float Mean_10 ;
+
+void Window_Callback ( _Sensor_SDS011 &Sensor, int N, float PM_2_5, float PM_10 ) {
+  Windows += 1 ;
+  Mean_2_5 = PM_2_5 ;
+  Mean_10  = PM_10 ;
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+int main () {
+  _SDS011_Simulator Sim ;
+  Sim.Trace = { { 0x0A0D, 0x1103 } } ;        // LF CR, ^C XON
+  Sim.ID    = 0x137F ;                        // XOFF DEL
+  _Host_PTY Port ( Sim ) ;
+  CHECK ( Port.Is_Open () ) ;
+
+  _Sensor_SDS011 Sensor ( Port ) ;
+  Sensor.Set_Mode ( SDS011_MODE_ACTIVE ) ;
+  SDS011_Window_Callback = Window_Callback ;
+
+  std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now () ;
+  while ( ( Windows < WINDOWS ) && ( millis () < 3600000 ) ) {
+    Sensor.loop () ;
+    Host_Advance ( 100 ) ;
+  }
+  while ( Sensor.Commands_Pending () && ( millis () < 3600000 ) ) {
+    Sensor.loop () ;
+    Host_Advance ( 100 ) ;
+  }
+  double Real_s = std::chrono::duration < double > ( std::chrono::steady_clock::now () - Start ).count () ;
+
+  // *************************************************
+  // the frames and commands through the tty
+  // *************************************************
+  CHECK ( Windows == WINDOWS ) ;
+  CHECK ( Sensor.Parser ().Checksum_Errors == 0 ) ;
+  CHECK ( Sensor.Parser ().Sync_Errors     == 0 ) ;
+  CHECK ( Sensor.Parser ().Frames_OK       >  Sim.Frames_Sent ) ;
+  CHECK ( Sensor.Commands_Failed == 0 ) ;
+  CHECK ( Sensor.Commands_OK     >  0 ) ;
+  CHECK ( Sim.Wake_Times.size () == WINDOWS - 1 ) ;
+  CHECK ( ! Sim.Working ) ;
+  CHECK ( Port.Bytes_To_Device == SDS011_COMMAND_LEN * ( Sensor.Commands_OK + Sensor.Commands_Failed ) ) ;
+  CHECK ( Port.Bytes_To_Driver == 10 * Sensor.Parser ().Frames_OK ) ;
+
+  // *************************************************
+  // the values
+  // *************************************************
+  CHECK ( fabs ( Mean_2_5 - 0.1 * 0x0A0D ) < 0.01 ) ;
+  CHECK ( fabs ( Mean_10  - 0.1 * 0x1103 ) < 0.01 ) ;
+
+  printf ( "  %s : %lu bytes to the sensor, %lu bytes to the driver, %d working periods\n",
+           Port.Name (), Port.Bytes_To_Device, Port.Bytes_To_Driver, WINDOWS ) ;
+  printf ( "  %.0f s simulated in %.2f s\n", 0.001 * millis (), Real_s ) ;
+  return Test_Result ( "SDS011_PTY" ) ;
+}
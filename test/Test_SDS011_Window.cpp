@@ -0,0 +1,210 @@
+// ***********************************************************************************
+// Host test of the automatic working period of the SDS011 driver ( SDS_AUTO_WINDOW ),
+//   on an SDS011 trace ( test/traces/SDS011_Trace.txt, or the file given as argument ).
+//
+// Every working period of the trace is measured by the driver, with a simulated sensor,
+//   once with the fixed working period ( 20 s, Start_Sample ) and once automatic,
+//   both with the outlier filter ( SDS_OUTLIER_FILTER ), the trace has spikes.
+// Checked :
+//   - the end of the warm-up and the end of the working period are the same as
+//     an independent calculation of the rules on the accepted samples :
+//       warm-up done : drift and SD of the last K = 5 samples < tolerance
+//       window done  : 95% confidence interval of the mean < tolerance
+//       tolerance    = Warmup_Abs + Warmup_Rel * mean
+//   - the mean is not less accurate than with the fixed working period,
+//     compared to the steady level ( mean of the last 10 seconds of the trace ),
+//     only if the trace ends steady ( a rising level has no single right answer )
+//   - the total on-time of the laser and fan is less
+// ***********************************************************************************
+#include <Arduino.h>
+#include "ext_def.h"
+#include <ESP8266WiFi.h>
+
+int    debug = 0 ;
+String esp_chipid ;
+char   msg [ 1000 ] ;
+
+#include "Sensor_SDS011.h"
+#include "Host_Test.h"
+#include "SDS011_Simulator.h"
+
+
+// ***********************************************************************************
+// One working period, as measured by the driver
+// ***********************************************************************************
+struct _Run {
+  int                     N ;            // samples in the mean
+  float                   Mean ;         // PM2.5 [ug/m3]
+  unsigned long           On_ms ;        // wake-up until the end of the working period
+  std::vector < uint16_t > Accepted ;    // all accepted samples, 0.1 ug/m3
+} ;
+
+_Run *Current = NULL ;
+
+void Sample_Callback ( _Sensor_SDS011 &Sensor ) {
+  Current -> Accepted.push_back ( Sensor.PM_2_5 ) ;
+}
+
+void Window_Callback ( _Sensor_SDS011 &Sensor, int N, float PM_2_5, float PM_10 ) {
+  Current -> N     = N ;
+  Current -> Mean  = PM_2_5 ;
+  Current -> On_ms = millis () ;
+}
+
+_Run Measure ( const _SDS011_Trace &Trace, bool Auto_Window ) {
+  _Run Run = { 0, 0, 0 } ;
+  Current     = &Run ;
+  Host_Millis = 0 ;
+  _SDS011_Simulator Sim ;
+  Sim.Trace = Trace ;
+  _Sensor_SDS011 Sensor ( Sim ) ;
+  Sensor.Auto_Window    = Auto_Window ;
+  Sensor.Outlier_Filter = true ;
+  Sensor.Set_Mode ( SDS011_MODE_ACTIVE ) ;
+  while ( ( Sensor.Window_Count == 0 ) && ( millis () < 60000 ) ) {
+    Sensor.loop () ;
+    Host_Advance ( 100 ) ;
+  }
+  return Run ;
+}
+
+
+// ***********************************************************************************
+// The rules of the driver, calculated in double on the accepted samples
+//   Warmup = number of samples until the warm-up is done ( that sample is the first in the mean )
+//   End    = number of samples at the early end, 0 if the working period doesn't end early
+// ***********************************************************************************
+struct _Decision {
+  int    Warmup ;
+  int    End ;
+} ;
+
+_Decision Reference ( const std::vector < uint16_t > &y, const _Sensor_SDS011 &P ) {
+  _Decision D = { 0, 0 } ;
+  const int K = SDS011_WARMUP_K ;
+  for ( int n = 1; n <= (int) y.size (); n++ ) {
+    if ( D.Warmup == 0 ) {
+      bool Done = ( n >= P.Warmup_Max_Samples ) ;
+      if ( ! Done && ( n >= K ) ) {
+        double Mean = 0 ;
+        for ( int i = 0; i < K; i++ ) {
+          Mean += 0.1 * y [ n - K + i ] ;
+        }
+        Mean /= K ;
+        double Sum_xy = 0, Sum_x2 = 0, Sum_y2 = 0 ;
+        for ( int i = 0; i < K; i++ ) {
+          double dx = i - 0.5 * ( K - 1 ) ;
+          double dy = 0.1 * y [ n - K + i ] - Mean ;
+          Sum_xy += dx * dy ;
+          Sum_x2 += dx * dx ;
+          Sum_y2 += dy * dy ;
+        }
+        double Tolerance = P.Warmup_Abs + P.Warmup_Rel * Mean ;
+        Done = ( fabs ( Sum_xy / Sum_x2 ) * K < Tolerance ) && ( sqrt ( Sum_y2 / K ) < Tolerance ) ;
+      }
+      if ( ! Done ) {
+        continue ;
+      }
+      D.Warmup = n ;
+    }
+    int    N    = n - D.Warmup + 1 ;
+    double Mean = 0, M2 = 0 ;
+    for ( int i = D.Warmup - 1; i < n; i++ ) {
+      Mean += 0.1 * y [i] ;
+    }
+    Mean /= N ;
+    for ( int i = D.Warmup - 1; i < n; i++ ) {
+      M2 += sq ( 0.1 * y [i] - Mean ) ;
+    }
+    if ( ( N >= P.Auto_Min_Samples ) && ( 1.96 * sqrt ( M2 / N ) / sqrt ( N ) < P.Warmup_Abs + P.Warmup_Rel * Mean ) ) {
+      D.End = n ;
+      return D ;
+    }
+  }
+  return D ;
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+int main ( int argc, char **argv ) {
+  const char *File_Name = ( argc > 1 ) ? argv[1] : "test/traces/SDS011_Trace.txt" ;
+  std::vector < _SDS011_Trace > Traces = SDS011_Read_Traces ( File_Name ) ;
+  CHECK ( Traces.size () > 0 ) ;
+
+  SDS011_Sample_Callback = Sample_Callback ;
+  SDS011_Window_Callback = Window_Callback ;
+
+  _SDS011_Simulator Dummy ;
+  _Sensor_SDS011    Defaults ( Dummy ) ;
+  unsigned long On_Fixed = 0 ;
+  unsigned long On_Auto  = 0 ;
+
+  printf ( "  period  warm-up  N fixed  N auto  on fixed  on auto   steady   fixed    auto\n" ) ;
+  for ( size_t p = 0; p < Traces.size (); p++ ) {
+    const _SDS011_Trace &Trace = Traces [p] ;
+    _Run Fixed = Measure ( Trace, false ) ;
+    _Run Auto  = Measure ( Trace, true ) ;
+
+    // *************************************************
+    // the decisions of the driver, sample by sample
+    // *************************************************
+    _Decision D = Reference ( Auto.Accepted, Defaults ) ;
+    CHECK ( D.Warmup > 0 ) ;
+    if ( D.End > 0 ) {
+      CHECK ( (int) Auto.Accepted.size () == D.End ) ;
+      CHECK ( Auto.N == D.End - D.Warmup + 1 ) ;
+    }
+    else {
+      CHECK ( Auto.On_ms > (unsigned long) Defaults.Working_Time_ms ) ;
+    }
+    double Mean = 0 ;
+    for ( int i = D.Warmup - 1; i < (int) Auto.Accepted.size (); i++ ) {
+      Mean += 0.1 * Auto.Accepted [i] ;
+    }
+    Mean /= Auto.Accepted.size () - D.Warmup + 1 ;
+    CHECK ( fabs ( Auto.Mean - Mean ) < 0.01 ) ;
+
+    // ***************************************************
+    // accuracy, compared to the last 10 s of the trace,
+    //   steady unless the drift over that time is above the tolerance
+    //   with 95% confidence ( the slope of a noisy level isn't 0 )
+    // ***************************************************
+    int    N_Steady = min ( 10, (int) Trace.size () ) ;
+    double Steady   = 0 ;
+    double Sum_xy   = 0 ;
+    double Sum_x2   = 0 ;
+    double Sum_r2   = 0 ;
+    for ( int i = 0; i < N_Steady; i++ ) {
+      Steady += 0.1 * Trace [ Trace.size () - N_Steady + i ].PM_2_5 ;
+    }
+    Steady /= N_Steady ;
+    for ( int i = 0; i < N_Steady; i++ ) {
+      double dx = i - 0.5 * ( N_Steady - 1 ) ;
+      Sum_xy += dx * ( 0.1 * Trace [ Trace.size () - N_Steady + i ].PM_2_5 - Steady ) ;
+      Sum_x2 += dx * dx ;
+    }
+    double Slope = Sum_xy / Sum_x2 ;
+    for ( int i = 0; i < N_Steady; i++ ) {
+      double dx = i - 0.5 * ( N_Steady - 1 ) ;
+      Sum_r2 += sq ( 0.1 * Trace [ Trace.size () - N_Steady + i ].PM_2_5 - Steady - Slope * dx ) ;
+    }
+    double SE_Slope  = sqrt ( Sum_r2 / ( N_Steady - 2 ) / Sum_x2 ) ;
+    double Tolerance = Defaults.Warmup_Abs + Defaults.Warmup_Rel * Steady ;
+    bool   Is_Steady = ( ( fabs ( Slope ) - 1.96 * SE_Slope ) * N_Steady < Tolerance ) ;
+    if ( Is_Steady ) {
+      CHECK ( fabs ( Auto.Mean - Steady ) <= max ( fabs ( Fixed.Mean - Steady ), Tolerance ) ) ;
+    }
+
+    On_Fixed += Fixed.On_ms ;
+    On_Auto  += Auto.On_ms ;
+    printf ( "  %6d  %7d  %7d  %6d  %8.1f  %7.1f  %7.2f%c  %6.2f  %6.2f\n",
+             (int) p + 1, D.Warmup, Fixed.N, Auto.N, 0.001 * Fixed.On_ms, 0.001 * Auto.On_ms,
+             Steady, Is_Steady ? ' ' : '*', Fixed.Mean, Auto.Mean ) ;
+  }
+  CHECK ( On_Auto < On_Fixed ) ;
+  printf ( "  * not steady, accuracy not checked\n" ) ;
+  printf ( "  on-time per working period : fixed %.1f s, automatic %.1f s\n",
+           0.001 * On_Fixed / Traces.size (), 0.001 * On_Auto / Traces.size () ) ;
+  return Test_Result ( "SDS011_Window" ) ;
+}
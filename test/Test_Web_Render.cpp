@@ -0,0 +1,231 @@
+// ***********************************************************************************
+// Host benchmark of the template renderer of the web server ( Web_Server.h ),
+//   compared to the LuftDaten way of building a page :
+//   copy the PROGMEM template in a String and String::replace every placeholder.
+//
+// The pages are the root and restart page of Web_Pages.h, with the same templates
+//   ( html-content.h ) and values, the functions return fixed texts.
+// Checked :
+//   - the renderer gives the same page as the String way, for any chunk size
+//   - the renderer doesn't use the heap, the String way holds the whole page
+// Reported : render throughput ( host time ) and peak memory of both.
+// ***********************************************************************************
+#include <chrono>
+#include <new>
+#include <Arduino.h>
+#include "ext_def.h"
+#include <ESP8266WiFi.h>
+
+int    debug = 0 ;
+String esp_chipid ;
+char   msg [ 1000 ] ;
+
+#include "Web_Server.h"
+#include "Host_Test.h"
+
+#define RENDERS   20000
+
+
+// ***********************************************************************************
+// Heap use, all allocations of the test program are counted
+// ***********************************************************************************
+size_t Heap_Used = 0 ;
+size_t Heap_Peak = 0 ;
+
+void *operator new ( size_t Size ) {
+  size_t *P = (size_t*) malloc ( Size + 16 ) ;
+  if ( P == NULL ) {
+    throw std::bad_alloc () ;
+  }
+  P [0]      = Size ;
+  Heap_Used += Size ;
+  Heap_Peak  = max ( Heap_Peak, Heap_Used ) ;
+  return (char*) P + 16 ;
+}
+
+void operator delete ( void *Data ) noexcept {
+  if ( Data == NULL ) {
+    return ;
+  }
+  size_t *P  = (size_t*) ( (char*) Data - 16 ) ;
+  Heap_Used -= P [0] ;
+  free ( P ) ;
+}
+
+void operator delete ( void *Data, size_t ) noexcept {
+  operator delete ( Data ) ;
+}
+
+
+// ***********************************************************************************
+// The pages, as in Web_Pages.h
+// ***********************************************************************************
+void Web_Chip_ID ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "%u", ESP.getChipId () ) ;
+}
+void Web_MAC ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "5C:CF:7F:12:34:56" ) ;
+}
+void Web_Firmware ( char *Buffer, int Size ) {
+  snprintf ( Buffer, Size, "0.4" ) ;
+}
+
+#define WEB_HEADER_VALUES(Title) \
+  { "t",   Title }, \
+  { "tt",  "FijnStof Sensor" }, \
+  { "id",  NULL, Web_Chip_ID }, \
+  { "mac", NULL, Web_MAC }, \
+  { "fwt", "Firmware" }, \
+  { "fw",  NULL, Web_Firmware }, \
+  { "h",   "Home" }, \
+  { "n",   ( Title [0] != 0 ) ? "&raquo;" : "" }, \
+  { NULL }
+
+const _Web_Value Web_Root_Header   [] = { WEB_HEADER_VALUES ( "" ) } ;
+const _Web_Value Web_Reset_Header  [] = { WEB_HEADER_VALUES ( "Restart" ) } ;
+
+const _Web_Value Web_Footer_Values [] = {
+  { "t", "Back to home" },
+  { NULL }
+} ;
+
+const _Web_Value Web_Root_Values [] = {
+  { "t",           "Current values" },
+  { "karte",       "Map" },
+  { "conf",        "Configuration" },
+  { "conf_delete", "Delete configuration" },
+  { "restart",     "Restart" },
+  { NULL }
+} ;
+
+const _Web_Value Web_Reset_Values [] = {
+  { "t", "Restart the sensor?" },
+  { "b", "Restart" },
+  { "c", "Cancel" },
+  { NULL }
+} ;
+
+_Web_Part Web_Root_Parts [] = {
+  { WEB_PAGE_HEADER,       Web_Root_Header },
+  { WEB_ROOT_PAGE_CONTENT, Web_Root_Values },
+  { WEB_PAGE_FOOTER,       Web_Footer_Values },
+  { NULL }
+} ;
+
+_Web_Part Web_Reset_Parts [] = {
+  { WEB_PAGE_HEADER,       Web_Reset_Header },
+  { WEB_RESET_CONTENT,     Web_Reset_Values },
+  { WEB_PAGE_FOOTER,       Web_Footer_Values },
+  { NULL }
+} ;
+
+
+// ***********************************************************************************
+// The LuftDaten way : the whole page in a String, every placeholder replaced
+// ***********************************************************************************
+String Render_String ( const _Web_Part *Parts ) {
+  String Page ;
+  for ( const _Web_Part *Part = Parts; Part->Template != NULL; Part++ ) {
+    String Text = FPSTR ( Part->Template ) ;
+    for ( const _Web_Value *Value = Part->Values; Value->Name != NULL; Value++ ) {
+      char Buffer [ WEB_VALUE_SIZE ] = "" ;
+      if ( Value->Get != NULL ) {
+        Value->Get ( Buffer, sizeof ( Buffer ) ) ;
+      }
+      Text.replace ( String ( "{" ) + Value->Name + "}", ( Value->Get != NULL ) ? Buffer : Value->Text ) ;
+    }
+    Page += Text ;
+  }
+  return Page ;
+}
+
+// ***********************************************************************************
+// The renderer, in chunks of Size bytes as the web server sends them
+// ***********************************************************************************
+_Template_Renderer Renderer ;
+
+std::string Render_Chunks ( const _Web_Part *Parts, int Size ) {
+  std::string Page ;
+  char        Chunk [ WEB_CHUNK_SIZE ] ;
+  Renderer.Start ( Parts ) ;
+  for ( int N; ( N = Renderer.Fill ( Chunk, Size ) ) > 0; ) {
+    Page.append ( Chunk, N ) ;
+  }
+  return Page ;
+}
+
+double Seconds_Since ( std::chrono::steady_clock::time_point Start ) {
+  return std::chrono::duration < double > ( std::chrono::steady_clock::now () - Start ).count () ;
+}
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+int main () {
+  Renderer.Compile ( Web_Root_Parts ) ;
+  Renderer.Compile ( Web_Reset_Parts ) ;
+  CHECK ( Web_Root_Parts [0].N_Segments > 1 ) ;
+
+  printf ( "  page     bytes   string [MB/s]  renderer [MB/s]   string peak heap  renderer peak heap + buffer\n" ) ;
+  const _Web_Part *Pages [] = { Web_Root_Parts, Web_Reset_Parts } ;
+  const char      *Names [] = { "/",        "/reset" } ;
+  for ( int p = 0; p < 2; p++ ) {
+    // *************************************************
+    // same output, for any chunk size
+    // *************************************************
+    std::string Expected = Render_String ( Pages [p] ).c_str () ;
+    CHECK ( Expected.find ( "{t}" ) == std::string::npos ) ;
+    CHECK ( Render_Chunks ( Pages [p], 1 )              == Expected ) ;
+    CHECK ( Render_Chunks ( Pages [p], 7 )              == Expected ) ;
+    CHECK ( Render_Chunks ( Pages [p], WEB_CHUNK_SIZE ) == Expected ) ;
+
+    // *************************************************
+    // peak heap during one render
+    // *************************************************
+    size_t Base = Heap_Used ;
+    Heap_Peak   = Heap_Used ;
+    {
+      String Page = Render_String ( Pages [p] ) ;
+    }
+    size_t String_Peak = Heap_Peak - Base ;
+
+    char Chunk [ WEB_CHUNK_SIZE ] ;
+    Heap_Peak = Heap_Used ;
+    Renderer.Start ( Pages [p] ) ;
+    while ( Renderer.Fill ( Chunk, sizeof ( Chunk ) ) > 0 ) {
+    }
+    size_t Renderer_Peak = Heap_Peak - Base ;
+    CHECK ( Renderer_Peak == 0 ) ;
+    CHECK ( String_Peak >= Expected.size () ) ;
+
+    // *************************************************
+    // throughput
+    // *************************************************
+    size_t Bytes = 0 ;
+    std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now () ;
+    for ( int i = 0; i < RENDERS; i++ ) {
+      String Page = Render_String ( Pages [p] ) ;
+      Bytes += Page.length () ;
+    }
+    double String_s = Seconds_Since ( Start ) ;
+
+    Start = std::chrono::steady_clock::now () ;
+    for ( int i = 0; i < RENDERS; i++ ) {
+      Renderer.Start ( Pages [p] ) ;
+      for ( int N; ( N = Renderer.Fill ( Chunk, sizeof ( Chunk ) ) ) > 0; ) {
+        Bytes -= N ;
+      }
+    }
+    double Renderer_s = Seconds_Since ( Start ) ;
+    CHECK ( Bytes == 0 ) ;
+
+    double MB = 1e-6 * RENDERS * Expected.size () ;
+    printf ( "  %-7s  %5d  %13.1f  %15.1f  %17d  %18d + %d\n",
+             Names [p], (int) Expected.size (), MB / String_s, MB / Renderer_s,
+             (int) String_Peak, (int) Renderer_Peak, (int) sizeof ( Chunk ) ) ;
+  }
+  printf ( "  renderer state %d bytes, segments %d of %d ( %d bytes )\n",
+           (int) sizeof ( _Template_Renderer ), Renderer.Segments_Used (), WEB_SEGMENTS,
+           (int) ( WEB_SEGMENTS * sizeof ( _Web_Segment ) ) ) ;
+  return Test_Result ( "Web_Render" ) ;
+}
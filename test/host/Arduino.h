@@ -0,0 +1,242 @@
+// ***********************************************************************************
+// This file is a host ( Linux ) replacement of the Arduino core,
+//   just enough to run the header-only modules of this project in a test program.
+//
+// The time is simulated : millis and micros return Host_Millis,
+//   a test moves the time with Host_Advance.
+// The serial ports discard their output, unless Host_Serial_Echo is set.
+// The RTC user memory of the ESP8266 is an array, so it survives a simulated deep sleep.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Host_Arduino_h
+#define _Host_Arduino_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <deque>
+
+typedef bool    boolean ;
+typedef uint8_t byte ;
+
+#define PROGMEM
+#define PGM_P       const char *
+#define F(x)        x
+#define FPSTR(x)    x
+#define PSTR(x)     x
+#define memcpy_P    memcpy
+#define strcpy_P    strcpy
+#define strncpy_P   strncpy
+#define strlen_P    strlen
+#define pgm_read_byte(x)   ( *(const uint8_t*) (x) )
+
+#define HEX  16
+#define DEC  10
+
+#define D0   16
+#define D1   5
+#define D2   4
+#define D3   0
+#define D4   2
+#define D5   14
+#define D6   12
+#define D7   13
+#define D8   15
+
+#define min(a,b)            ( (a) < (b) ? (a) : (b) )
+#define max(a,b)            ( (a) > (b) ? (a) : (b) )
+#define constrain(x,l,h)    ( (x) < (l) ? (l) : ( (x) > (h) ? (h) : (x) ) )
+#define sq(x)               ( (x) * (x) )
+
+
+// ***********************************************************************************
+// Simulated time
+// ***********************************************************************************
+unsigned long Host_Millis = 0 ;
+
+unsigned long millis () { return Host_Millis ; }
+unsigned long micros () { return 1000 * Host_Millis ; }
+void delay ( unsigned long ms ) { Host_Millis += ms ; }
+void yield () {}
+void wdt_reset () {}
+
+void Host_Advance ( unsigned long ms ) { Host_Millis += ms ; }
+
+
+// ***********************************************************************************
+// String, on top of std::string
+// ***********************************************************************************
+class String {
+  public:
+    String () {}
+    String ( const char *s ) : _S ( s ? s : "" ) {}
+    String ( const std::string &s ) : _S ( s ) {}
+    String ( char c ) : _S ( 1, c ) {}
+    String ( int           v, unsigned char Base = 10 ) { _Number ( v, Base ) ; }
+    String ( unsigned int  v, unsigned char Base = 10 ) { _Number ( v, Base ) ; }
+    String ( long          v, unsigned char Base = 10 ) { _Number ( v, Base ) ; }
+    String ( unsigned long v, unsigned char Base = 10 ) { _Number ( v, Base ) ; }
+    String ( double v, unsigned char Decimals = 2 ) {
+      char Buffer [ 40 ] ;
+      snprintf ( Buffer, sizeof ( Buffer ), "%.*f", Decimals, v ) ;
+      _S = Buffer ;
+    }
+
+    const char   *c_str  () const { return _S.c_str () ; }
+    unsigned int  length () const { return _S.length () ; }
+    void          reserve ( unsigned int n ) { _S.reserve ( n ) ; }
+    char operator [] ( unsigned int i ) const { return ( i < _S.length () ) ? _S [i] : 0 ; }
+
+    String &operator += ( const String &s ) { _S += s._S ; return *this ; }
+    String &operator += ( const char *s )   { _S += s ; return *this ; }
+    String &operator += ( char c )          { _S += c ; return *this ; }
+    friend String operator + ( const String &a, const String &b ) { return String ( a._S + b._S ) ; }
+    friend String operator + ( const String &a, const char *b )   { return String ( a._S + b ) ; }
+    friend String operator + ( const char *a, const String &b )   { return String ( a + b._S ) ; }
+
+    bool operator == ( const String &s ) const { return _S == s._S ; }
+    bool operator == ( const char *s )   const { return _S == s ; }
+    bool operator != ( const String &s ) const { return _S != s._S ; }
+    bool operator != ( const char *s )   const { return _S != s ; }
+
+    int indexOf ( char c ) const          { size_t p = _S.find ( c ) ; return ( p == std::string::npos ) ? -1 : p ; }
+    int indexOf ( const char *s ) const   { size_t p = _S.find ( s ) ; return ( p == std::string::npos ) ? -1 : p ; }
+    int lastIndexOf ( char c ) const      { size_t p = _S.rfind ( c ) ; return ( p == std::string::npos ) ? -1 : p ; }
+    bool startsWith ( const char *s ) const { return _S.compare ( 0, strlen ( s ), s ) == 0 ; }
+    String substring ( unsigned int From ) const { return ( From < _S.length () ) ? String ( _S.substr ( From ) ) : String () ; }
+    String substring ( unsigned int From, unsigned int To ) const {
+      return ( From < To && From < _S.length () ) ? String ( _S.substr ( From, To - From ) ) : String () ;
+    }
+    void remove ( unsigned int From ) { if ( From < _S.length () ) _S.erase ( From ) ; }
+    void remove ( unsigned int From, unsigned int Count ) { if ( From < _S.length () ) _S.erase ( From, Count ) ; }
+    void replace ( const String &From, const String &To ) {
+      if ( From._S.empty () ) return ;
+      size_t p = 0 ;
+      while ( ( p = _S.find ( From._S, p ) ) != std::string::npos ) {
+        _S.replace ( p, From._S.length (), To._S ) ;
+        p += To._S.length () ;
+      }
+    }
+    long toInt () const { return atol ( _S.c_str () ) ; }
+
+  private:
+    std::string _S ;
+
+    template < typename T >
+    void _Number ( T v, unsigned char Base ) {
+      char Buffer [ 40 ] ;
+      if ( Base == 16 ) {
+        snprintf ( Buffer, sizeof ( Buffer ), "%lx", (unsigned long) v ) ;
+      }
+      else {
+        snprintf ( Buffer, sizeof ( Buffer ), ( v < 0 ) ? "%ld" : "%lu", (long) v ) ;
+      }
+      _S = Buffer ;
+    }
+} ;
+
+
+// ***********************************************************************************
+// Print and Stream
+// ***********************************************************************************
+bool Host_Serial_Echo = false ;
+
+class Print {
+  public:
+    virtual size_t write ( uint8_t c ) = 0 ;
+    virtual size_t write ( const uint8_t *Buffer, size_t Len ) {
+      for ( size_t i = 0; i < Len; i++ ) {
+        write ( Buffer [i] ) ;
+      }
+      return Len ;
+    }
+    size_t write ( const char *s ) { return write ( (const uint8_t*) s, strlen ( s ) ) ; }
+    virtual void flush () {}
+
+    size_t print   ( const char *s )   { return write ( s ) ; }
+    size_t print   ( const String &s ) { return write ( s.c_str () ) ; }
+    size_t print   ( char c )          { return write ( (uint8_t) c ) ; }
+    size_t print   ( long v, int Base = 10 )          { return print ( String ( v, Base ) ) ; }
+    size_t print   ( unsigned long v, int Base = 10 ) { return print ( String ( v, Base ) ) ; }
+    size_t print   ( int v, int Base = 10 )           { return print ( String ( v, Base ) ) ; }
+    size_t print   ( unsigned int v, int Base = 10 )  { return print ( String ( v, Base ) ) ; }
+    size_t print   ( double v, int Decimals = 2 )     { return print ( String ( v, Decimals ) ) ; }
+    size_t println () { return write ( "\n" ) ; }
+    template < typename T > size_t println ( T v ) { return print ( v ) + println () ; }
+    template < typename T > size_t println ( T v, int f ) { return print ( v, f ) + println () ; }
+    size_t printf ( const char *Format, ... ) {
+      char    Buffer [ 256 ] ;
+      va_list Args ;
+      va_start ( Args, Format ) ;
+      vsnprintf ( Buffer, sizeof ( Buffer ), Format, Args ) ;
+      va_end ( Args ) ;
+      return write ( Buffer ) ;
+    }
+} ;
+
+class Stream : public Print {
+  public:
+    virtual int available () = 0 ;
+    virtual int read () = 0 ;
+    virtual int peek () = 0 ;
+} ;
+
+class HardwareSerial : public Stream {
+  public:
+    using Print::write ;
+    size_t write ( uint8_t c ) override {
+      if ( Host_Serial_Echo ) {
+        putchar ( c ) ;
+      }
+      return 1 ;
+    }
+    int  available () override { return 0 ; }
+    int  read () override { return -1 ; }
+    int  peek () override { return -1 ; }
+    void begin ( unsigned long ) {}
+    void swap () {}
+    size_t setRxBufferSize ( size_t n ) { return n ; }
+    operator bool () { return true ; }
+} ;
+
+HardwareSerial Serial ;
+HardwareSerial Serial1 ;
+
+
+// ***********************************************************************************
+// ESP8266 specific : chip-id, heap and the RTC user memory ( 512 bytes )
+// ***********************************************************************************
+#define RF_DEFAULT  0
+
+class EspClass {
+  public:
+    uint8_t  RTC_Memory [ 512 ] ;
+    uint64_t Deep_Sleep_us = 0 ;
+
+    uint32_t getChipId ()   { return 0x123456 ; }
+    uint32_t getFreeHeap () { return 40000 ; }
+    bool rtcUserMemoryRead ( uint32_t Offset, uint32_t *Data, size_t Size ) {
+      if ( 4 * Offset + Size > sizeof ( RTC_Memory ) ) return false ;
+      memcpy ( Data, RTC_Memory + 4 * Offset, Size ) ;
+      return true ;
+    }
+    bool rtcUserMemoryWrite ( uint32_t Offset, uint32_t *Data, size_t Size ) {
+      if ( 4 * Offset + Size > sizeof ( RTC_Memory ) ) return false ;
+      memcpy ( RTC_Memory + 4 * Offset, Data, Size ) ;
+      return true ;
+    }
+    void deepSleep ( uint64_t us, int Mode = RF_DEFAULT ) { Deep_Sleep_us = us ; }
+} ;
+
+EspClass ESP ;
+
+#endif
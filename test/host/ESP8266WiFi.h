@@ -0,0 +1,38 @@
+// ***********************************************************************************
+// This file is a host ( Linux ) replacement of ESP8266WiFi.
+// Just enough for LuftDaten.h and Web_Server.h : a connection always fails,
+//   nothing is sent and the server never has a client.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Host_ESP8266WiFi_h
+#define _Host_ESP8266WiFi_h
+
+#include <Arduino.h>
+
+class WiFiClient : public HardwareSerial {
+  public:
+    void setNoDelay ( bool ) {}
+    void setTimeout ( unsigned long ) {}
+    int  connect ( const char *Host, uint16_t Port ) { return 0 ; }
+    bool connected () { return false ; }
+    int  availableForWrite () { return 0 ; }
+    size_t write_P ( const char *Buffer, size_t Len ) { return write ( (const uint8_t*) Buffer, Len ) ; }
+    void stop () {}
+} ;
+
+class WiFiServer {
+  public:
+    WiFiServer ( uint16_t Port ) {}
+    void begin () {}
+    void setNoDelay ( bool ) {}
+    bool hasClient () { return false ; }
+    WiFiClient available () { return WiFiClient () ; }
+} ;
+
+class WiFiClientSecure : public WiFiClient {
+} ;
+
+#endif
@@ -0,0 +1,194 @@
+// ***********************************************************************************
+// This file is the host ( Linux ) serial transport : a pseudo terminal,
+//   so a driver reads and writes a real tty, as it would a UART.
+//
+// The driver gets the slave side as a Stream, raw mode ( no echo, no line editing,
+//   no CR/LF translation, no XON/XOFF or signal characters ), 9600 8N1.
+// The master side is connected to a device Stream ( e.g. the simulated SDS011 ) :
+//   bytes written by the driver go through the tty to the device,
+//   the output of the device goes through the tty back to the driver.
+// The transfer is done in the calls of the driver, there's no pacing at 9600 baud,
+//   so the driver runs at full speed with the simulated time of the host core.
+//
+//   _SDS011_Simulator Sim ;
+//   _Host_PTY         Port ( Sim ) ;
+//   _Sensor_SDS011    Sensor ( Port ) ;
+//
+// Public Functions implemented :
+//     _Host_PTY ( Stream &Device ) {       // opens the pseudo terminal
+//     bool        Is_Open () {
+//     const char *Name () {                // name of the slave, e.g. /dev/pts/3
+//     unsigned long Bytes_To_Device, Bytes_To_Driver
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Host_PTY_h
+#define _Host_PTY_h
+
+#include <Arduino.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#define HOST_PTY_TIMEOUT_MS   1000      // maximum time the kernel may take to pass bytes on
+
+
+// ***********************************************************************************
+// ***********************************************************************************
+class _Host_PTY : public Stream {
+
+  public:
+    unsigned long Bytes_To_Device = 0 ;
+    unsigned long Bytes_To_Driver = 0 ;
+
+    using Print::write ;
+
+    // ***********************************************************************
+    // ***********************************************************************
+    _Host_PTY ( Stream &Device ) {
+      _Device = &Device ;
+      _Master = posix_openpt ( O_RDWR | O_NOCTTY ) ;
+      if ( ( _Master < 0 ) || ( grantpt ( _Master ) != 0 ) || ( unlockpt ( _Master ) != 0 ) ) {
+        perror ( "Host_PTY" ) ;
+        return ;
+      }
+      strncpy ( _Name, ptsname ( _Master ), sizeof ( _Name ) - 1 ) ;
+      _Slave = open ( _Name, O_RDWR | O_NOCTTY ) ;
+      if ( _Slave < 0 ) {
+        perror ( "Host_PTY" ) ;
+        return ;
+      }
+      struct termios Mode ;
+      tcgetattr ( _Slave, &Mode ) ;
+      cfmakeraw ( &Mode ) ;
+      cfsetispeed ( &Mode, B9600 ) ;
+      cfsetospeed ( &Mode, B9600 ) ;
+      Mode.c_cc [ VMIN  ] = 0 ;
+      Mode.c_cc [ VTIME ] = 0 ;
+      tcsetattr ( _Slave, TCSANOW, &Mode ) ;
+      fcntl ( _Master, F_SETFL, O_NONBLOCK ) ;
+      fcntl ( _Slave,  F_SETFL, O_NONBLOCK ) ;
+    }
+
+    ~_Host_PTY () {
+      if ( _Slave >= 0 ) {
+        close ( _Slave ) ;
+      }
+      if ( _Master >= 0 ) {
+        close ( _Master ) ;
+      }
+    }
+
+    bool Is_Open () {
+      return _Slave >= 0 ;
+    }
+
+    const char *Name () {
+      return _Name ;
+    }
+
+    // ***********************************************************************
+    // The Stream of the driver, the slave side
+    // ***********************************************************************
+    size_t write ( uint8_t c ) override {
+      if ( ! Is_Open () || ( ::write ( _Slave, &c, 1 ) != 1 ) ) {
+        return 0 ;
+      }
+      _To_Device += 1 ;
+      return 1 ;
+    }
+
+    int available () override {
+      _Transfer () ;
+      return _To_Driver + ( _Peeked >= 0 ) ;
+    }
+
+    int read () override {
+      int c = peek () ;
+      _Peeked = -1 ;
+      return c ;
+    }
+
+    int peek () override {
+      if ( _Peeked >= 0 ) {
+        return _Peeked ;
+      }
+      _Transfer () ;
+      uint8_t c ;
+      if ( ( _To_Driver == 0 ) || ( ::read ( _Slave, &c, 1 ) != 1 ) ) {
+        return -1 ;
+      }
+      _To_Driver -= 1 ;
+      _Peeked     = c ;
+      return _Peeked ;
+    }
+
+
+  // ***********************************************************************
+  private:
+  // ***********************************************************************
+    Stream       *_Device ;
+    int           _Master     = -1 ;
+    int           _Slave      = -1 ;
+    char          _Name [ 64 ] = "" ;
+    int           _Peeked     = -1 ;
+    unsigned long _To_Device  = 0 ;     // written by the driver, not yet read by the device
+    unsigned long _To_Driver  = 0 ;     // written by the device, not yet read by the driver
+
+    // ***********************************************************************
+    // The kernel passes bytes on asynchronously, so wait until Count bytes
+    //   can be read from the file, to keep the test deterministic.
+    // After the timeout the bytes are counted as lost, as on a UART.
+    // ***********************************************************************
+    bool _Wait ( int File, unsigned long Count ) {
+      for ( int Waited = 0; Waited < HOST_PTY_TIMEOUT_MS; Waited++ ) {
+        int N = 0 ;
+        ioctl ( File, FIONREAD, &N ) ;
+        if ( (unsigned long) N >= Count ) {
+          return true ;
+        }
+        struct pollfd Poll = { File, POLLIN, 0 } ;
+        poll ( &Poll, 1, 1 ) ;
+      }
+      fprintf ( stderr, "Host_PTY : %lu bytes not passed on by %s\n", Count, _Name ) ;
+      return false ;
+    }
+
+    // ***********************************************************************
+    // Commands of the driver to the device, the output of the device to the driver
+    // ***********************************************************************
+    void _Transfer () {
+      if ( ! Is_Open () ) {
+        return ;
+      }
+      uint8_t Buffer [ 256 ] ;
+      if ( _To_Device > 0 ) {
+        _Wait ( _Master, _To_Device ) ;
+        int N ;
+        while ( ( N = ::read ( _Master, Buffer, sizeof ( Buffer ) ) ) > 0 ) {
+          _Device -> write ( Buffer, N ) ;
+          Bytes_To_Device += N ;
+        }
+        _To_Device = 0 ;
+      }
+      int N = 0 ;
+      while ( ( N < (int) sizeof ( Buffer ) ) && ( _Device -> available () > 0 ) ) {
+        Buffer [ N++ ] = _Device -> read () ;
+      }
+      if ( ( N > 0 ) && ( ::write ( _Master, Buffer, N ) == N ) ) {
+        _To_Driver      += N ;
+        Bytes_To_Driver += N ;
+      }
+      if ( ( _To_Driver > 0 ) && ! _Wait ( _Slave, _To_Driver ) ) {
+        int Available = 0 ;
+        ioctl ( _Slave, FIONREAD, &Available ) ;
+        _To_Driver = Available ;
+      }
+    }
+} ;
+
+#endif
@@ -0,0 +1,32 @@
+// ***********************************************************************************
+// Minimal test support for the host tests :
+//   CHECK ( Condition ) counts and reports a failed condition, the test continues,
+//   Test_Result () prints the summary and is the exit code of main.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Host_Test_h
+#define _Host_Test_h
+
+#include <stdio.h>
+
+int Test_Checks   = 0 ;
+int Test_Failures = 0 ;
+
+#define CHECK(Condition)                                                          \
+  do {                                                                            \
+    Test_Checks += 1 ;                                                            \
+    if ( ! ( Condition ) ) {                                                      \
+      Test_Failures += 1 ;                                                        \
+      printf ( "FAILED %s:%d : %s\n", __FILE__, __LINE__, #Condition ) ;          \
+    }                                                                             \
+  } while ( 0 )
+
+int Test_Result ( const char *Name ) {
+  printf ( "%-20s %d checks, %d failed\n", Name, Test_Checks, Test_Failures ) ;
+  return ( Test_Failures == 0 ) ? 0 : 1 ;
+}
+
+#endif
@@ -0,0 +1,20 @@
+// ***********************************************************************************
+// This file is a host ( Linux ) replacement of SoftwareSerial.
+// Output is discarded and nothing is received,
+//   a test gives the sensor its own Stream ( e.g. a simulated sensor ) instead.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Host_SoftwareSerial_h
+#define _Host_SoftwareSerial_h
+
+#include <Arduino.h>
+
+class SoftwareSerial : public HardwareSerial {
+  public:
+    SoftwareSerial ( int RX, int TX, bool Inverted = false, int Buffer_Size = 64 ) {}
+} ;
+
+#endif
@@ -0,0 +1,61 @@
+// ***********************************************************************************
+// This file is a host ( Linux ) replacement of WiFiUDP.
+// Nothing is sent, every datagram is kept in Packets, so a test can decode it.
+// ***********************************************************************************
+
+// ***************************
+// To prevent multiple imports
+// ***************************
+#ifndef _Host_WiFiUdp_h
+#define _Host_WiFiUdp_h
+
+#include <Arduino.h>
+#include <vector>
+
+struct _Host_Packet {
+  std::string          Host ;
+  uint16_t             Port ;
+  std::vector<uint8_t> Data ;
+} ;
+
+class WiFiUDP {
+  public:
+    std::vector<_Host_Packet> Packets ;
+    bool                      Fail = false ;     // let beginPacket fail, e.g. no route
+
+    int beginPacket ( const char *Host, uint16_t Port ) {
+      if ( Fail ) {
+        return 0 ;
+      }
+      _Open      = true ;
+      _Open_Host = Host ;
+      _Open_Port = Port ;
+      _Open_Data.clear () ;
+      return 1 ;
+    }
+
+    size_t write ( const uint8_t *Buffer, size_t Len ) {
+      if ( ! _Open ) {
+        return 0 ;
+      }
+      _Open_Data.insert ( _Open_Data.end (), Buffer, Buffer + Len ) ;
+      return Len ;
+    }
+
+    int endPacket () {
+      if ( ! _Open ) {
+        return 0 ;
+      }
+      _Open = false ;
+      Packets.push_back ( { _Open_Host, _Open_Port, _Open_Data } ) ;
+      return 1 ;
+    }
+
+  private:
+    bool                 _Open      = false ;
+    std::string          _Open_Host ;
+    uint16_t             _Open_Port = 0 ;
+    std::vector<uint8_t> _Open_Data ;
+} ;
+
+#endif
@@ -0,0 +1,22 @@
+#!/bin/sh
+# ***********************************************************************************
+# Builds and runs the host tests, from the root of the repository :
+#     sh test/run_tests.sh
+# The tests use the host replacement of the Arduino core in test/host
+# char is unsigned, as on the ESP8266 ( html-content.h depends on it )
+# ***********************************************************************************
+CXX=${CXX:-g++}
+OUT=${TMPDIR:-/tmp}/fijnstof_tests
+mkdir -p $OUT
+
+Failed=0
+for Test in test/Test_*.cpp ; do
+  Name=$(basename $Test .cpp)
+  if $CXX -std=gnu++11 -O1 -funsigned-char -DESP8266 -Itest/host -I. -o $OUT/$Name $Test ; then
+    $OUT/$Name || Failed=1
+  else
+    echo "$Name : build failed"
+    Failed=1
+  fi
+done
+exit $Failed